@@ -0,0 +1,302 @@
+/*
+ * Microbenchmarks for the hot paths in actuator_sensor_control.cpp
+ *
+ * Every benchmark is parameterized by joint count (6, 30, 60, 200) and run
+ * with 1, 2 and 4 threads. Each thread builds its own objects, so the
+ * thread variants show how a path scales when several controllers share
+ * the machine (allocator, cache and memory bandwidth pressure), not lock
+ * contention inside one controller.
+ *
+ * Built by CMake as actuator_sensor_control_bench when Google Benchmark
+ * is installed.
+ */
+
+#include "humanoid_control/humanoid_control.hpp"
+
+#include <benchmark/benchmark.h>
+
+namespace {
+
+constexpr int64_t kPeriodNs = 1000000;  // 1kHz loop
+
+std::vector<std::string> jointNames(size_t count) {
+    std::vector<std::string> names;
+    names.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        names.push_back("joint_" + std::to_string(i));
+    }
+    return names;
+}
+
+void jointAndThreadCounts(benchmark::internal::Benchmark* b) {
+    b->ArgName("joints");
+    for (int joints : {6, 30, 60, 200}) {
+        b->Arg(joints);
+    }
+    b->Threads(1)->Threads(2)->Threads(4);
+}
+
+// Everything one controller's joints need, without the controller. The
+// bus is never started, so staged commands stay in its pending frame.
+struct JointRig {
+    JointStateBank state;
+    PidBank pid;
+    SafetyLimits limits;
+    std::deque<JointController> controllers;
+    std::deque<JointSensor> sensors;
+    CommandBus bus;
+
+    explicit JointRig(size_t joints) : state(joints), pid(joints), limits(joints) {
+        const std::vector<std::string> names = jointNames(joints);
+        for (size_t j = 0; j < joints; ++j) {
+            controllers.emplace_back(names[j], state, pid, limits, j);
+            controllers.back().attachBus(bus);
+            sensors.emplace_back(names[j] + "_pos_sensor");
+            pid.enabled[j] = -1;
+            pid.target[j] = 0.1;
+        }
+    }
+};
+
+}  // namespace
+
+static void BM_JointSensorRead(benchmark::State& state) {
+    const size_t joints = static_cast<size_t>(state.range(0));
+    JointRig rig(joints);
+    int64_t now = 0;
+    for (auto _ : state) {
+        now += kPeriodNs;
+        for (auto& sensor : rig.sensors) {
+            sensor.read(now);
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * joints);
+}
+BENCHMARK(BM_JointSensorRead)->Apply(jointAndThreadCounts);
+
+// The acquisition path the loop uses: batched noise, then every sensor
+static void BM_AcquisitionPollJoints(benchmark::State& state) {
+    const size_t joints = static_cast<size_t>(state.range(0));
+    JointRig rig(joints);
+    SensorAcquisition acquisition(kPeriodNs, kPeriodNs);
+    for (auto& sensor : rig.sensors) {
+        acquisition.addJointSensor(&sensor);
+    }
+    int64_t now = 0;
+    for (auto _ : state) {
+        now += kPeriodNs;
+        acquisition.pollJoints(now);
+        acquisition.drainJoints([](const JointSample& sample) {
+            benchmark::DoNotOptimize(sample);
+        });
+    }
+    state.SetItemsProcessed(state.iterations() * joints);
+}
+BENCHMARK(BM_AcquisitionPollJoints)->Apply(jointAndThreadCounts);
+
+// One IMU per joint, to scale with the same parameter as the joint paths
+static void BM_ImuSensorRead(benchmark::State& state) {
+    const size_t imus = static_cast<size_t>(state.range(0));
+    std::deque<ImuSensor> sensors;
+    for (size_t i = 0; i < imus; ++i) {
+        sensors.emplace_back("imu_" + std::to_string(i));
+    }
+    int64_t now = 0;
+    for (auto _ : state) {
+        now += kPeriodNs;
+        for (auto& sensor : sensors) {
+            sensor.read(now);
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * imus);
+}
+BENCHMARK(BM_ImuSensorRead)->Apply(jointAndThreadCounts);
+
+static void BM_JointControllerUpdate(benchmark::State& state) {
+    const size_t joints = static_cast<size_t>(state.range(0));
+    JointRig rig(joints);
+    for (auto _ : state) {
+        for (auto& controller : rig.controllers) {
+            controller.update(0.001);
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * joints);
+}
+BENCHMARK(BM_JointControllerUpdate)->Apply(jointAndThreadCounts);
+
+// The batched replacement for per-joint update() used by the loop
+static void BM_PidKernelStep(benchmark::State& state) {
+    const size_t joints = static_cast<size_t>(state.range(0));
+    JointRig rig(joints);
+    PidKernel kernel(joints);
+    AlignedArray<double> torque(joints);
+    for (auto _ : state) {
+        kernel.step(rig.pid, rig.state, 0.001, torque.data());
+        benchmark::DoNotOptimize(torque.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * joints);
+    state.SetLabel(kernel.usesAvx2() ? "avx2" : "scalar");
+}
+BENCHMARK(BM_PidKernelStep)->Apply(jointAndThreadCounts);
+
+static void BM_SensorFusionUpdateJointState(benchmark::State& state) {
+    const size_t joints = static_cast<size_t>(state.range(0));
+    SensorFusion fusion;
+    std::vector<SensorFusion::JointHandle> handles;
+    for (const auto& name : jointNames(joints)) {
+        handles.push_back(fusion.registerJoint(name));
+    }
+    JointState sample;
+    for (auto _ : state) {
+        sample.timestamp_ns += kPeriodNs;
+        sample.position += 1e-6;
+        for (auto handle : handles) {
+            fusion.updateJointState(handle, sample);
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * joints);
+}
+BENCHMARK(BM_SensorFusionUpdateJointState)->Apply(jointAndThreadCounts);
+
+// One IMU per joint; only the torso IMU runs the balance EKF, the rest are
+// plain stores, so this shows the EKF cost against the per-IMU overhead
+static void BM_SensorFusionUpdateImuData(benchmark::State& state) {
+    const size_t imus = static_cast<size_t>(state.range(0));
+    SensorFusion fusion;
+    std::vector<SensorFusion::ImuHandle> handles;
+    for (size_t i = 0; i < imus; ++i) {
+        handles.push_back(fusion.registerImu(i == 0 ? "torso_imu" : "imu_" + std::to_string(i)));
+    }
+    ImuData sample;
+    for (auto _ : state) {
+        sample.timestamp_ns += kPeriodNs;
+        sample.angular_velocity[0] = 1e-3;
+        for (auto handle : handles) {
+            fusion.updateImuData(handle, sample);
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * imus);
+}
+BENCHMARK(BM_SensorFusionUpdateImuData)->Apply(jointAndThreadCounts);
+
+// One balance stage: predict to the IMU sample, the accelerometer update
+// and both hip updates. Target: under 2us per cycle.
+static void BM_BalanceEkfCycle(benchmark::State& state) {
+    BalanceEkf ekf;
+    const double gyro[3] = {0.01, -0.02, 0.0};
+    const double accel[3] = {0.1, -0.2, 9.8};
+    int64_t now = 0;
+    for (auto _ : state) {
+        now += kPeriodNs;
+        ekf.updateImu(gyro, accel, now);
+        ekf.updateHip(0.01, now);
+        ekf.updateHip(-0.01, now);
+        benchmark::DoNotOptimize(ekf.roll());
+    }
+}
+BENCHMARK(BM_BalanceEkfCycle)->Threads(1)->Threads(2)->Threads(4);
+
+static void BM_SafetyMonitorCheckSafety(benchmark::State& state) {
+    const size_t joints = static_cast<size_t>(state.range(0));
+    JointRig rig(joints);
+    EmergencyStop estop;
+    SafetyMonitor monitor(rig.state, rig.limits, estop);
+    for (size_t j = 0; j < joints; ++j) {
+        monitor.addController(&rig.controllers[j]);
+        monitor.addJointSensor(&rig.sensors[j]);
+    }
+    int64_t now = 0;
+    for (auto _ : state) {
+        now += kPeriodNs;
+        // Keep samples fresh so the check never latches the e-stop
+        for (size_t j = 0; j < joints; ++j) {
+            rig.state.timestampNs()[j] = now;
+        }
+        benchmark::DoNotOptimize(monitor.checkSafety(now));
+    }
+    state.SetItemsProcessed(state.iterations() * joints);
+}
+BENCHMARK(BM_SafetyMonitorCheckSafety)->Apply(jointAndThreadCounts);
+
+// One control period on virtual time: every base tick in it, with each
+// stage (sensors, balance, PID and bus, safety) at its own rate. The
+// controller is rebuilt whenever the safety monitor stops it, outside the
+// timed region.
+static void BM_ControlCycle(benchmark::State& state) {
+    const size_t joints = static_cast<size_t>(state.range(0));
+    const std::vector<std::string> names = jointNames(joints);
+    std::unique_ptr<HumanoidController> controller;
+    auto rebuild = [&] {
+        controller.reset(new HumanoidController(1e9 / kPeriodNs, names));
+        controller->enableVirtualTime();
+        controller->beginSimulation();
+    };
+    rebuild();
+    for (auto _ : state) {
+        if (!controller->stepSimulation()) {
+            state.PauseTiming();
+            rebuild();
+            state.ResumeTiming();
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * joints);
+}
+BENCHMARK(BM_ControlCycle)->Apply(jointAndThreadCounts);
+
+// The same cycle with the topology fixed at compile time; compare with
+// BM_ControlCycle at the same joint count
+template <typename Robot>
+static void BM_StaticControlCycle(benchmark::State& state) {
+    std::unique_ptr<StaticHumanoidController<Robot>> controller;
+    auto rebuild = [&] {
+        controller.reset(new StaticHumanoidController<Robot>(1e9 / kPeriodNs));
+        controller->enableVirtualTime();
+        controller->beginSimulation();
+    };
+    rebuild();
+    for (auto _ : state) {
+        if (!controller->stepSimulation()) {
+            state.PauseTiming();
+            rebuild();
+            state.ResumeTiming();
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * StaticHumanoidController<Robot>::kJointCount);
+}
+BENCHMARK_TEMPLATE(BM_StaticControlCycle, SixJointBiped)->Threads(1)->Threads(2)->Threads(4);
+
+// A whole 16-run sweep on a pool of range(0) workers. Wall time, not CPU
+// time, so the worker counts show how the sweep scales across cores.
+static void BM_Sweep(benchmark::State& state) {
+    std::vector<SweepParameters> grid(16);
+    for (size_t i = 0; i < grid.size(); ++i) {
+        grid[i].kp = 50.0 + 10.0 * static_cast<double>(i);
+    }
+    SweepOptions options;
+    options.duration = 0.25;
+    options.threads = static_cast<size_t>(state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(SweepRunner::run(grid, options));
+    }
+    state.SetItemsProcessed(state.iterations() * grid.size());
+}
+BENCHMARK(BM_Sweep)->ArgName("workers")->Arg(1)->Arg(2)->Arg(4)->Arg(8)
+    ->UseRealTime()->Unit(benchmark::kMillisecond);
+
+int main(int argc, char** argv) {
+    // Controllers log their start-up; keep that out of the results
+    AsyncLogger::instance().setEnabled(false);
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,194 @@
+// Sensor acquisition pipeline
+
+#ifndef HUMANOID_CONTROL_ACQUISITION_HPP
+#define HUMANOID_CONTROL_ACQUISITION_HPP
+
+#include "humanoid_control/core.hpp"
+#include "humanoid_control/state.hpp"
+#include "humanoid_control/sensors.hpp"
+#include "humanoid_control/executor.hpp"
+
+// Sensor acquisition pipeline. Joint encoders and IMUs are read on their
+// own threads, each feeding an SPSC ring of timestamped samples that the
+// control thread drains in batches, so acquisition and estimation run on
+// different cores and a slow IMU read cannot stall joint control. Joint
+// temperatures are read on the joint thread at their own, much lower rate
+// and ride along with the encoder samples. Without start() the same poll
+// functions can be driven inline from the control thread.
+class SensorAcquisition {
+public:
+    static constexpr size_t kRingCapacity = 256;
+    using JointRing = SpscRing<JointSample, kRingCapacity>;
+    using ImuRing = SpscRing<ImuSample, kRingCapacity>;
+
+private:
+    std::vector<JointSensor*> joint_sensors_;
+    std::vector<ImuSensor*> imu_sensors_;
+    JointRing joint_ring_;
+    ImuRing imu_ring_;
+    ImuBatch imu_batch_;        // One lane per IMU, integrated in one call
+    
+    NoiseBank joint_noise_;     // Noise for every joint sensor, one call per poll
+    AlignedArray<double> joint_noise_values_;
+    uint64_t noise_seed_;
+    
+    PeriodicExecutor joint_executor_;
+    PeriodicExecutor imu_executor_;
+    int64_t temperature_period_ns_;
+    std::thread joint_thread_;
+    std::thread imu_thread_;
+    bool threaded_;
+
+public:
+    SensorAcquisition(int64_t joint_period_ns, int64_t imu_period_ns,
+                      int64_t temperature_period_ns = JointSensor::kTemperaturePeriodNs)
+        : noise_seed_(Noise::kDefaultSeed),
+          joint_executor_(joint_period_ns), imu_executor_(imu_period_ns),
+          temperature_period_ns_(temperature_period_ns), threaded_(false) {}
+    
+    ~SensorAcquisition() { stop(); }
+    
+    SensorAcquisition(const SensorAcquisition&) = delete;
+    SensorAcquisition& operator=(const SensorAcquisition&) = delete;
+    
+    // Sample index in the ring matches the registration order
+    void addJointSensor(JointSensor* sensor) {
+        joint_sensors_.push_back(sensor);
+        seedJointNoise(noise_seed_);
+    }
+    
+    // Seed the batched joint noise; lanes are (sensor, channel) pairs
+    uint64_t noiseSeed() const { return noise_seed_; }
+    
+    void seedJointNoise(uint64_t seed) {
+        noise_seed_ = seed;
+        const size_t channels = JointSensor::kNoiseChannels;
+        joint_noise_ = NoiseBank(joint_sensors_.size() * channels);
+        joint_noise_values_ = AlignedArray<double>(joint_noise_.size());
+        for (size_t i = 0; i < joint_sensors_.size(); ++i) {
+            for (size_t ch = 0; ch < channels; ++ch) {
+                joint_noise_.seedLane(i * channels + ch,
+                                      Noise::streamSeed(seed, joint_sensors_[i]->getName(), ch),
+                                      joint_sensors_[i]->getNoiseLevel());
+            }
+        }
+    }
+    void addImuSensor(ImuSensor* sensor) {
+        imu_sensors_.push_back(sensor);
+        imu_batch_ = ImuBatch(imu_sensors_.size());
+    }
+    
+    // Acquisition thread rates; call before start()
+    void setPeriods(int64_t joint_period_ns, int64_t imu_period_ns, int64_t temperature_period_ns) {
+        joint_executor_.setPeriod(joint_period_ns);
+        imu_executor_.setPeriod(imu_period_ns);
+        temperature_period_ns_ = temperature_period_ns;
+    }
+    
+    void start() {
+        if (threaded_) return;
+        threaded_ = true;
+        joint_executor_.rearm();
+        imu_executor_.rearm();
+        joint_thread_ = std::thread([this] {
+            int64_t next_temperature_ns = 0;
+            joint_executor_.run([&](const PeriodicExecutor::TickInfo& tick) {
+                if (tick.release_ns >= next_temperature_ns) {
+                    pollTemperatures(tick.wake_ns);
+                    next_temperature_ns = tick.release_ns + temperature_period_ns_;
+                }
+                pollJoints(tick.wake_ns);
+                return true;
+            });
+        });
+        imu_thread_ = std::thread([this] {
+            imu_executor_.run([this](const PeriodicExecutor::TickInfo& tick) {
+                pollImus(tick.wake_ns);
+                return true;
+            });
+        });
+    }
+    
+    void stop() {
+        if (!threaded_) return;
+        joint_executor_.stop();
+        imu_executor_.stop();
+        if (joint_thread_.joinable()) joint_thread_.join();
+        if (imu_thread_.joinable()) imu_thread_.join();
+        threaded_ = false;
+    }
+    
+    bool isThreaded() const { return threaded_; }
+    
+    // Producer side: read every sensor and push one sample each
+    void pollJoints(int64_t now_ns) {
+        joint_noise_.fill(joint_noise_values_.data());
+        
+        JointSample sample;
+        for (size_t i = 0; i < joint_sensors_.size(); ++i) {
+            joint_sensors_[i]->read(now_ns, &joint_noise_values_[i * JointSensor::kNoiseChannels]);
+            sample.joint = static_cast<uint32_t>(i);
+            joint_sensors_[i]->getState(sample.state);
+            joint_ring_.tryPush(sample);
+        }
+    }
+    
+    // Read every joint temperature; published with the next encoder sample
+    void pollTemperatures(int64_t now_ns) {
+        for (JointSensor* sensor : joint_sensors_) {
+            sensor->readTemperature(now_ns);
+        }
+    }
+    
+    // Sample every IMU, integrate all orientations in one batched call,
+    // then publish and push
+    void pollImus(int64_t now_ns) {
+        const size_t n = imu_sensors_.size();
+        for (size_t i = 0; i < n; ++i) {
+            ImuSensor& imu = *imu_sensors_[i];
+            imu.sample(now_ns);
+            const ImuData& data = imu.workingData();
+            imu_batch_.qx[i] = data.orientation[0];
+            imu_batch_.qy[i] = data.orientation[1];
+            imu_batch_.qz[i] = data.orientation[2];
+            imu_batch_.qw[i] = data.orientation[3];
+            imu_batch_.wx[i] = data.angular_velocity[0];
+            imu_batch_.wy[i] = data.angular_velocity[1];
+            imu_batch_.wz[i] = data.angular_velocity[2];
+            imu_batch_.dt[i] = imu.sampleInterval();
+        }
+        
+        ImuIntegrator::integrate(imu_batch_);
+        
+        ImuSample sample;
+        for (size_t i = 0; i < n; ++i) {
+            ImuSensor& imu = *imu_sensors_[i];
+            ImuData& data = imu.workingData();
+            data.orientation[0] = imu_batch_.qx[i];
+            data.orientation[1] = imu_batch_.qy[i];
+            data.orientation[2] = imu_batch_.qz[i];
+            data.orientation[3] = imu_batch_.qw[i];
+            imu.publish();
+            
+            sample.imu = static_cast<uint32_t>(i);
+            sample.data = data;
+            imu_ring_.tryPush(sample);
+        }
+    }
+    
+    // Producer side for samples that come from elsewhere, e.g. a replayed
+    // log; do not mix with start()
+    bool pushJoint(const JointSample& sample) { return joint_ring_.tryPush(sample); }
+    bool pushImu(const ImuSample& sample) { return imu_ring_.tryPush(sample); }
+    
+    // Consumer side (control thread)
+    template <typename Fn>
+    size_t drainJoints(Fn&& fn) { return joint_ring_.drain(std::forward<Fn>(fn)); }
+    
+    template <typename Fn>
+    size_t drainImus(Fn&& fn) { return imu_ring_.drain(std::forward<Fn>(fn)); }
+    
+    uint64_t droppedSamples() const { return joint_ring_.dropped() + imu_ring_.dropped(); }
+};
+
+#endif  // HUMANOID_CONTROL_ACQUISITION_HPP
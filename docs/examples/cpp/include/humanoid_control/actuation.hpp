@@ -0,0 +1,385 @@
+// Actuators, the emergency stop and the command bus
+
+#ifndef HUMANOID_CONTROL_ACTUATION_HPP
+#define HUMANOID_CONTROL_ACTUATION_HPP
+
+#include "humanoid_control/core.hpp"
+
+// Actuator class with control
+class Actuator {
+private:
+    std::string name_;
+    double current_torque_;
+    double max_torque_;
+    double gear_ratio_;
+    double efficiency_;
+    mutable std::mutex mutex_;
+
+public:
+    Actuator(const std::string& name, double max_torque = 50.0, double gear_ratio = 100.0)
+        : name_(name), current_torque_(0.0), max_torque_(max_torque), 
+          gear_ratio_(gear_ratio), efficiency_(0.9) {}
+    
+    // Latch a torque setpoint. The electrical/bus response time is paid once
+    // per frame by CommandBus, not per joint here.
+    bool setTorque(double torque) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        
+        // Apply limits
+        torque = std::clamp(torque, -max_torque_, max_torque_);
+        current_torque_ = torque;
+        
+        return true;
+    }
+    
+    double getTorque() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return current_torque_;
+    }
+    
+    const std::string& getName() const { return name_; }
+    double getMaxTorque() const { return max_torque_; }
+};
+
+// Latched emergency stop shared by the control loop, the safety watchdog
+// and the actuator dispatcher. Lock-free: trip and test are single atomic
+// operations, so a thread that is about to write an actuator can check it
+// without blocking on whoever tripped it. Once set it stays set.
+class EmergencyStop {
+public:
+    enum Reason : uint32_t {
+        Requested         = 1 << 0,   // triggerEmergencyStop()
+        LimitViolation    = 1 << 1,   // SafetyKernel found a violation
+        HeartbeatTimeout  = 1 << 2    // Control loop stopped making progress
+    };
+
+private:
+    std::atomic<uint32_t> reasons_;
+    std::atomic<int64_t> trip_time_ns_;
+
+public:
+    EmergencyStop() : reasons_(0), trip_time_ns_(0) {}
+    
+    EmergencyStop(const EmergencyStop&) = delete;
+    EmergencyStop& operator=(const EmergencyStop&) = delete;
+    
+    // Returns true for the call that tripped it
+    bool trigger(Reason reason, int64_t now_ns) {
+        const uint32_t previous = reasons_.fetch_or(reason, std::memory_order_acq_rel);
+        if (previous == 0) {
+            trip_time_ns_.store(now_ns, std::memory_order_relaxed);
+            return true;
+        }
+        return false;
+    }
+    
+    bool isActive() const { return reasons_.load(std::memory_order_acquire) != 0; }
+    uint32_t reasons() const { return reasons_.load(std::memory_order_acquire); }
+    int64_t tripTimeNs() const { return trip_time_ns_.load(std::memory_order_relaxed); }
+    
+    static void printReasons(std::ostream& out, uint32_t reasons) {
+        if (reasons & Requested) out << " requested";
+        if (reasons & LimitViolation) out << " limit-violation";
+        if (reasons & HeartbeatTimeout) out << " heartbeat-timeout";
+    }
+};
+
+// Per-cycle actuator command frame: one torque slot per attached actuator
+struct CommandFrame {
+    std::vector<double> torques;
+    std::vector<uint8_t> valid;     // Slot was staged this cycle
+    uint64_t sequence = 0;
+
+    void resize(size_t slots) {
+        torques.resize(slots, 0.0);
+        valid.resize(slots, 0);
+    }
+
+    void clear() {
+        std::fill(valid.begin(), valid.end(), 0);
+    }
+};
+
+// Command bus: controllers stage torques into a frame, a dispatcher thread
+// flushes the whole frame to the actuators as a single bus transaction.
+// The e-stop is checked before every actuator write; once it is active the
+// dispatcher drops all frames and commands zero torque instead.
+// On virtual time there is no dispatcher thread: published frames go into a
+// delay line and are written once the transaction latency has elapsed in
+// simulated time, so the latency is modelled without sleeping. The delay
+// line is drained by the next publish(); halt() writes the frames already
+// due and stop() writes the rest, as the dispatcher thread finishes the
+// frame it holds, so the last frames of a run still reach the actuators.
+class CommandBus {
+private:
+    std::vector<Actuator*> actuators_;
+    CommandFrame staging_;      // Owned by the control thread
+    CommandFrame pending_;      // Handed over to the dispatcher
+    bool has_pending_;
+    bool running_;
+    bool halt_requested_;
+    const EmergencyStop* estop_;
+    bool torque_off_;           // All actuators zeroed after an e-stop
+    double transaction_latency_;
+    uint64_t frames_sent_;
+    uint64_t frames_coalesced_;
+    uint64_t frames_dropped_;
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    std::thread dispatcher_;
+    
+    // Virtual-time delay line: ring of frames waiting for their due time
+    static constexpr size_t kDelayLineFrames = 64;
+    VirtualTime* virtual_time_;
+    std::vector<CommandFrame> delay_line_;
+    std::vector<int64_t> delay_due_ns_;
+    size_t delay_head_;
+    size_t delay_count_;
+
+public:
+    CommandBus(double transaction_latency = 0.001)  // 1ms per bus transaction
+        : has_pending_(false), running_(false), halt_requested_(false), estop_(nullptr),
+          torque_off_(false), transaction_latency_(transaction_latency),
+          frames_sent_(0), frames_coalesced_(0), frames_dropped_(0),
+          virtual_time_(nullptr), delay_head_(0), delay_count_(0) {}
+    
+    ~CommandBus() { stop(); }
+    
+    CommandBus(const CommandBus&) = delete;
+    CommandBus& operator=(const CommandBus&) = delete;
+    
+    // Register an actuator and return its slot in the command frame.
+    // Must be called before start().
+    size_t attach(Actuator* actuator) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (running_) {
+            throw std::logic_error("CommandBus: cannot attach while dispatching");
+        }
+        actuators_.push_back(actuator);
+        staging_.resize(actuators_.size());
+        pending_.resize(actuators_.size());
+        for (auto& frame : delay_line_) {
+            frame.resize(actuators_.size());
+        }
+        return actuators_.size() - 1;
+    }
+    
+    // Model the transaction latency on simulated time instead of sleeping
+    // on a dispatcher thread. Must be called before start().
+    void useVirtualTime(VirtualTime* time) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (running_) {
+            throw std::logic_error("CommandBus: cannot change time source while dispatching");
+        }
+        virtual_time_ = time;
+        delay_line_.resize(kDelayLineFrames);
+        delay_due_ns_.resize(kDelayLineFrames);
+        for (auto& frame : delay_line_) {
+            frame.resize(actuators_.size());
+        }
+        delay_head_ = 0;
+        delay_count_ = 0;
+    }
+    
+    // Must be called before start()
+    void setEmergencyStop(const EmergencyStop* estop) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (running_) {
+            throw std::logic_error("CommandBus: cannot change e-stop while dispatching");
+        }
+        estop_ = estop;
+    }
+    
+    // Wake the dispatcher so it can apply an e-stop even when no frame is
+    // pending, e.g. because the control loop has hung
+    void halt() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            halt_requested_ = true;
+            if (virtual_time_) {
+                drainDelayLine(virtual_time_->nowNs(), false);
+                bool wrote = false;
+                writeFrame(nullptr, wrote);
+            }
+        }
+        cv_.notify_one();
+    }
+    
+    // Stage a torque for this cycle (control thread only, never blocks)
+    void stage(size_t slot, double torque) {
+        staging_.torques[slot] = torque;
+        staging_.valid[slot] = 1;
+    }
+    
+    // Hand the staged frame to the dispatcher. If the previous frame has not
+    // been flushed yet it is superseded: only the latest setpoints matter.
+    void publish() {
+        if (virtual_time_) {
+            publishDelayed();
+            return;
+        }
+        uint64_t sequence;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            sequence = ++staging_.sequence;
+            if (has_pending_) {
+                frames_coalesced_++;
+                // Keep any slot that the new frame did not restage
+                for (size_t i = 0; i < staging_.valid.size(); ++i) {
+                    if (!staging_.valid[i] && pending_.valid[i]) {
+                        staging_.torques[i] = pending_.torques[i];
+                        staging_.valid[i] = 1;
+                    }
+                }
+            }
+            std::swap(staging_, pending_);
+            has_pending_ = true;
+        }
+        cv_.notify_one();
+        
+        // pending_ belongs to the dispatcher once the lock is released; the
+        // buffer swapped out of it is ours
+        staging_.sequence = sequence;
+        staging_.clear();
+    }
+    
+    void start() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (running_) return;
+        running_ = true;
+        if (!virtual_time_) {
+            dispatcher_ = std::thread(&CommandBus::dispatchLoop, this);
+        }
+    }
+    
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!running_) return;
+            running_ = false;
+            if (virtual_time_) {
+                drainDelayLine(INT64_MAX, false);
+            }
+        }
+        cv_.notify_one();
+        if (dispatcher_.joinable()) {
+            dispatcher_.join();
+        }
+    }
+    
+    size_t slotCount() const { return actuators_.size(); }
+    
+    uint64_t framesSent() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return frames_sent_;
+    }
+    
+    uint64_t framesCoalesced() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return frames_coalesced_;
+    }
+    
+    // Frames discarded because the e-stop was active
+    uint64_t framesDropped() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return frames_dropped_;
+    }
+
+private:
+    // One bus transaction. The e-stop is checked before every write; once
+    // it is active every actuator is zeroed (once) and the frame is
+    // abandoned. Returns false if the e-stop stopped the frame.
+    bool writeFrame(const CommandFrame* frame, bool& wrote) {
+        bool stopped = false;
+        for (size_t i = 0; i < actuators_.size(); ++i) {
+            if (estop_ && estop_->isActive()) {
+                stopped = true;
+                break;
+            }
+            if (frame && frame->valid[i]) {
+                actuators_[i]->setTorque(frame->torques[i]);
+                wrote = true;
+            }
+        }
+        
+        // Zero every actuator once; later frames are discarded
+        if (stopped && !torque_off_) {
+            for (auto* actuator : actuators_) {
+                actuator->setTorque(0.0);
+            }
+            torque_off_ = true;
+            wrote = true;
+        }
+        return !stopped;
+    }
+    
+    // Write the delayed frames due by up_to_ns, oldest first. With
+    // make_room a full delay line also writes its oldest frame early.
+    void drainDelayLine(int64_t up_to_ns, bool make_room) {
+        while (delay_count_ > 0 &&
+               (delay_due_ns_[delay_head_] <= up_to_ns ||
+                (make_room && delay_count_ == delay_line_.size()))) {
+            bool wrote = false;
+            if (writeFrame(&delay_line_[delay_head_], wrote)) {
+                frames_sent_++;
+            } else {
+                frames_dropped_++;
+            }
+            delay_head_ = (delay_head_ + 1) % delay_line_.size();
+            delay_count_--;
+        }
+    }
+    
+    // Virtual time: write every frame whose latency has elapsed, then queue
+    // this one
+    void publishDelayed() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const int64_t now = virtual_time_->nowNs();
+        drainDelayLine(now, true);
+        
+        // Swapping the vectors keeps this allocation-free
+        const size_t tail = (delay_head_ + delay_count_) % delay_line_.size();
+        staging_.sequence++;
+        const uint64_t sequence = staging_.sequence;
+        std::swap(delay_line_[tail], staging_);
+        delay_due_ns_[tail] = now + static_cast<int64_t>(transaction_latency_ * 1e9);
+        delay_count_++;
+        staging_.sequence = sequence;
+        staging_.clear();
+    }
+    
+    void dispatchLoop() {
+        CommandFrame in_flight;
+        in_flight.resize(actuators_.size());
+        
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true) {
+            cv_.wait(lock, [this] { return has_pending_ || halt_requested_ || !running_; });
+            if (!has_pending_ && !halt_requested_ && !running_) break;
+            
+            const bool had_frame = has_pending_;
+            std::swap(in_flight, pending_);
+            pending_.clear();
+            has_pending_ = false;
+            halt_requested_ = false;
+            lock.unlock();
+            
+            // One transaction for the whole frame
+            bool wrote = false;
+            const bool stopped = !writeFrame(had_frame ? &in_flight : nullptr, wrote);
+            if (wrote) {
+                Utils::sleep_for(transaction_latency_);  // Simulate bus/electrical response
+            }
+            
+            lock.lock();
+            if (!had_frame) continue;
+            if (stopped) {
+                frames_dropped_++;
+            } else {
+                frames_sent_++;
+            }
+        }
+    }
+};
+
+#endif  // HUMANOID_CONTROL_ACTUATION_HPP
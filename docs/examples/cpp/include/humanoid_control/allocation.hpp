@@ -0,0 +1,109 @@
+// Per-cycle scratch memory and the debug check for real-time allocations
+
+#ifndef HUMANOID_CONTROL_ALLOCATION_HPP
+#define HUMANOID_CONTROL_ALLOCATION_HPP
+
+#include "humanoid_control/core.hpp"
+#include "humanoid_control/state.hpp"
+
+// Monotonic scratch memory for one control cycle. Bump allocation out of a
+// buffer allocated at start-up; reset() at the top of every cycle gives it
+// all back at once, so std::pmr containers built inside a cycle never touch
+// the heap. Memory from one cycle must not be kept past the next reset().
+// A cycle that needs more than the buffer gets the rest from the upstream
+// resource and counts an overflow; under HUMANOID_ALLOC_GUARD that heap
+// fallback is reported like any other real-time allocation.
+class CycleArena : public std::pmr::memory_resource {
+public:
+    static constexpr size_t kDefaultBytes = 64 << 10;
+
+private:
+    AlignedArray<unsigned char> buffer_;
+    size_t used_;
+    size_t peak_;                           // Most bytes used by one cycle
+    uint64_t overflows_;
+    std::pmr::memory_resource* upstream_;
+
+public:
+    explicit CycleArena(size_t bytes = kDefaultBytes,
+                        std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+        : buffer_(bytes), used_(0), peak_(0), overflows_(0), upstream_(upstream) {}
+    
+    CycleArena(const CycleArena&) = delete;
+    CycleArena& operator=(const CycleArena&) = delete;
+    
+    void reset() { used_ = 0; }
+    
+    size_t capacity() const { return buffer_.size(); }
+    size_t used() const { return used_; }
+    size_t peakBytes() const { return peak_; }
+    uint64_t overflows() const { return overflows_; }
+
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        const size_t offset = (used_ + alignment - 1) & ~(alignment - 1);
+        if (offset + bytes <= buffer_.size()) {
+            used_ = offset + bytes;
+            peak_ = std::max(peak_, used_);
+            return buffer_.data() + offset;
+        }
+        ++overflows_;
+        return upstream_->allocate(bytes, alignment);
+    }
+    
+    // Arena memory comes back with reset(); only overflow blocks are freed
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+        const unsigned char* block = static_cast<const unsigned char*>(p);
+        if (block < buffer_.data() || block >= buffer_.data() + buffer_.size()) {
+            upstream_->deallocate(p, bytes, alignment);
+        }
+    }
+    
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+
+// Debug check that real-time threads do not allocate after start-up. Built
+// with HUMANOID_ALLOC_GUARD, src/allocation.cpp replaces the global
+// operator new and delete, and every allocation made by a thread inside an
+// armed Scope is counted and reported through AsyncLogger, or with
+// Policy::Abort ends the process so a debugger or core dump shows the call
+// stack. Without the macro the guard compiles away.
+class AllocationGuard {
+public:
+    enum Policy : uint8_t {
+        Report,
+        Abort,
+    };
+
+#ifdef HUMANOID_ALLOC_GUARD
+    static constexpr bool kEnabled = true;
+    
+    // Arm or disarm the calling thread; returns the previous state
+    static bool arm(bool armed);
+    static void setPolicy(Policy policy);
+    static uint64_t violations();
+#else
+    static constexpr bool kEnabled = false;
+    
+    static bool arm(bool) { return false; }
+    static void setPolicy(Policy) {}
+    static uint64_t violations() { return 0; }
+#endif
+
+    // Arms the calling thread for the lifetime of the scope; nests
+    class Scope {
+    private:
+        bool previous_;
+    
+    public:
+        Scope() : previous_(arm(true)) {}
+        ~Scope() { arm(previous_); }
+        
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    };
+};
+
+#endif  // HUMANOID_CONTROL_ALLOCATION_HPP
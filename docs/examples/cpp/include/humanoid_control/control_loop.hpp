@@ -0,0 +1,361 @@
+// Multi-rate control loop shared by the humanoid controllers
+
+#ifndef HUMANOID_CONTROL_CONTROL_LOOP_HPP
+#define HUMANOID_CONTROL_CONTROL_LOOP_HPP
+
+#include "humanoid_control/core.hpp"
+#include "humanoid_control/logging.hpp"
+#include "humanoid_control/actuation.hpp"
+#include "humanoid_control/safety_monitor.hpp"
+#include "humanoid_control/executor.hpp"
+#include "humanoid_control/instrumentation.hpp"
+#include "humanoid_control/rt_setup.hpp"
+#include "humanoid_control/safety_watchdog.hpp"
+#include "humanoid_control/allocation.hpp"
+#include "humanoid_control/scheduler.hpp"
+
+// Rate, CPU budget and first release of one loop stage
+struct StageTiming {
+    double rate_hz;
+    int64_t budget_ns;
+    int64_t phase_ns;
+};
+
+// Rates of the multi-rate loop. The executor ticks at the greatest common
+// divisor of the stage periods, so rates that divide each other keep the
+// tick long. Control and telemetry run at the controller's frequency.
+struct StageRates {
+    StageTiming imu{2000.0, 50000, 0};
+    StageTiming joints{1000.0, 50000, 0};
+    StageTiming temperature{10.0, 20000, 500000};   // Off the control ticks
+    StageTiming balance{500.0, 50000, 0};
+    StageTiming safety{2000.0, 50000, 0};
+    int64_t control_budget_ns = 200000;
+    int64_t telemetry_budget_ns = 50000;
+};
+
+// The real-time loop of a humanoid controller, written once for every
+// topology: the scheduler and the executor that ticks it, run() with its
+// RT setup and summary, the step-by-step simulation on virtual time and
+// the per-cycle instrumentation. Derived (CRTP, so the per-tick calls
+// inline) owns the robot and befriends ControlLoop<Derived>. It provides
+//   joint_controllers_, joint_sensors_, imu_sensors_   Iterable containers
+//   estop_, command_bus_, watchdog_
+//   void configureStages();        Register its stages with scheduler_
+//   void primeSensors(int64_t);    Read every sensor once before the loop
+//   void seedJointNoise(uint64_t); Seed the batched joint noise
+//   void startRun(bool simulated); Telemetry, threads; run() only
+//   void finishRun();              Undo startRun() before the bus stops
+//   void logStatus(int64_t);       The once-a-second status line
+template <typename Derived>
+class ControlLoop {
+protected:
+    using Tick = PeriodicExecutor::TickInfo;
+    
+    double control_frequency_;
+    std::atomic<bool> is_running_;
+    
+    StageRates rates_;
+    RateMonotonicScheduler scheduler_;
+    uint64_t ticks_per_control_;    // Base ticks per control period
+    
+    PeriodicExecutor executor_;
+    int64_t last_status_ns_;
+    RtConfig rt_config_;
+    CycleInstrumentation instrumentation_;
+    CycleArena cycle_arena_;    // Scratch for one cycle, reset at its start
+    
+    VirtualTime virtual_time_;  // Used after enableVirtualTime()
+    int64_t duration_ns_;       // 0: run until stop()
+    int64_t stop_at_ns_;
+    uint64_t simulation_cycle_;
+    
+    explicit ControlLoop(double frequency)
+        : control_frequency_(frequency), is_running_(false), ticks_per_control_(1),
+          executor_(static_cast<int64_t>(1e9 / frequency)), last_status_ns_(0),
+          duration_ns_(0), stop_at_ns_(INT64_MAX), simulation_cycle_(0) {}
+    
+    Derived& derived() { return static_cast<Derived&>(*this); }
+    const Derived& derived() const { return static_cast<const Derived&>(*this); }
+
+public:
+    ControlLoop(const ControlLoop&) = delete;
+    ControlLoop& operator=(const ControlLoop&) = delete;
+    
+    // Enable every joint controller and start the command bus
+    bool initialize() {
+        AsyncLogger& log = AsyncLogger::instance();
+        log.log(LogEvent::HumanoidInitializing);
+        for (auto& controller : derived().joint_controllers_) {
+            if (!controller.initialize()) {
+                log.log(LogEvent::ControllerInitFailed, controller.getName().c_str());
+                return false;
+            }
+        }
+        derived().command_bus_.setEmergencyStop(&derived().estop_);
+        derived().command_bus_.start();
+        log.log(LogEvent::HumanoidInitialized);
+        return true;
+    }
+    
+    void run() {
+        Derived& robot = derived();
+        AsyncLogger& log = AsyncLogger::instance();
+        if (!configureSchedule()) {
+            log.flush();
+            return;
+        }
+        if (!initialize()) {
+            log.log(LogEvent::HumanoidInitFailed);
+            log.flush();
+            return;
+        }
+        
+        // Configure this thread for real-time use before the first cycle. A
+        // simulation on virtual time has no deadlines to protect.
+        const bool simulated = executor_.clock().isVirtual();
+        if (!simulated) {
+            RtSetup::log(RtSetup::apply(rt_config_));
+        }
+        
+        is_running_ = true;
+        const int64_t start_ns = executor_.clock().sample();
+        last_status_ns_ = start_ns;
+        stop_at_ns_ = duration_ns_ > 0 ? start_ns + duration_ns_ : INT64_MAX;
+        
+        log.log(LogEvent::LoopStarting, control_frequency_);
+        log.log(LogEvent::ScheduleConfigured, scheduler_.taskCount(),
+                scheduler_.basePeriodNs() / 1000, scheduler_.utilization(),
+                scheduler_.utilizationBound());
+        log.log(LogEvent::StatusHeader);
+        log.log(LogEvent::StatusRule);
+        robot.primeSensors(start_ns);
+        
+        // The watchdog guards against real-time stalls; on virtual time
+        // it stays off
+        robot.startRun(simulated);
+        if (!simulated) {
+            robot.watchdog_.start();
+        }
+        
+        {
+            // Everything from here to shutdown must run without the heap
+            AllocationGuard::Scope no_allocation;
+            executor_.run([this](const Tick& tick) {
+                return runCycle(tick);
+            });
+        }
+        
+        robot.watchdog_.disarm();
+        if (robot.estop_.isActive()) {
+            robot.command_bus_.halt();
+        }
+        robot.watchdog_.stop();
+        robot.finishRun();
+        robot.command_bus_.stop();
+        
+        log.flush();
+        printSummary(std::cout);
+    }
+    
+    // One base tick: run every stage released now; returns false when the
+    // loop should stop
+    bool runCycle(const Tick& tick) {
+        Derived& robot = derived();
+        if (!is_running_ || robot.estop_.isActive() || tick.wake_ns >= stop_at_ns_) {
+            return false;
+        }
+        instrumentation_.record(CycleInstrumentation::WakeUp, tick.wake_ns - tick.release_ns);
+        
+        // Stage timings are CPU time, also when the tick is on virtual time
+        const int64_t cycle_start = PeriodicExecutor::monotonicNowNs();
+        cycle_arena_.reset();
+        scheduler_.tick(tick);
+        instrumentation_.record(CycleInstrumentation::Total,
+                                PeriodicExecutor::monotonicNowNs() - cycle_start);
+        robot.watchdog_.beat();
+        
+        if (tick.wake_ns - last_status_ns_ > 1000000000) {  // Print every second
+            robot.logStatus(tick.wake_ns);
+            last_status_ns_ = tick.wake_ns;
+        }
+        return true;
+    }
+    
+    // Simulation mode: the loop, sensor timestamps and actuator latency all
+    // run on simulated time, so the loop runs as fast as the CPU allows and
+    // sensors are read inline. Call before run(); pair with setDuration()
+    // to end the run.
+    void enableVirtualTime(int64_t start_ns = 0) {
+        virtual_time_.advanceTo(start_ns);
+        executor_.clock().useVirtual(&virtual_time_);
+        derived().command_bus_.useVirtualTime(&virtual_time_);
+    }
+    
+    // Stop after this much loop time (simulated time on virtual time)
+    void setDuration(double seconds) {
+        duration_ns_ = static_cast<int64_t>(seconds * 1e9);
+    }
+    
+    // Step-by-step simulation on virtual time, for callers that drive the
+    // loop themselves (e.g. to close it through a plant model). Sets up
+    // what run() would, without threads, RT setup or output.
+    bool beginSimulation() {
+        Derived& robot = derived();
+        if (!executor_.clock().isVirtual()) {
+            throw std::logic_error("ControlLoop: beginSimulation needs virtual time");
+        }
+        if (!configureSchedule()) {
+            return false;
+        }
+        for (auto& controller : robot.joint_controllers_) {
+            if (!controller.initialize()) {
+                return false;
+            }
+        }
+        robot.command_bus_.setEmergencyStop(&robot.estop_);
+        robot.command_bus_.start();
+        
+        const int64_t start_ns = executor_.clock().sample();
+        last_status_ns_ = start_ns;
+        stop_at_ns_ = duration_ns_ > 0 ? start_ns + duration_ns_ : INT64_MAX;
+        simulation_cycle_ = 0;
+        robot.primeSensors(start_ns);
+        is_running_ = true;
+        return true;
+    }
+    
+    // Advance virtual time by one control period, running every base tick
+    // in it
+    bool stepSimulation() {
+        CycleClock& clock = executor_.clock();
+        for (uint64_t i = 0; i < ticks_per_control_; ++i) {
+            const int64_t release = clock.sample() + executor_.periodNs();
+            clock.sleepUntil(release);
+            const Tick tick{simulation_cycle_++, release, clock.sample(), executor_.periodNs(), 0};
+            clock.publish(tick.wake_ns);
+            if (!runCycle(tick)) {
+                return false;
+            }
+        }
+        return true;
+    }
+    
+    // Reseed every simulated sensor; runs with the same seed see the same noise
+    void setNoiseSeed(uint64_t seed) {
+        for (auto& sensor : derived().joint_sensors_) {
+            sensor.setNoiseSeed(seed);
+        }
+        for (auto& sensor : derived().imu_sensors_) {
+            sensor.setNoiseSeed(seed);
+        }
+        derived().seedJointNoise(seed);
+    }
+    
+    void setRealtimeConfig(const RtConfig& config) {
+        rt_config_ = config;
+    }
+    
+    // Stage rates and budgets; call before run() or beginSimulation()
+    void setStageRates(const StageRates& rates) {
+        rates_ = rates;
+    }
+    
+    const StageRates& stageRates() const { return rates_; }
+    const RateMonotonicScheduler& scheduler() const { return scheduler_; }
+    
+    void setExecutorOptions(const PeriodicExecutor::Options& options) {
+        executor_.setOptions(options);
+    }
+    
+    const PeriodicExecutor& executor() const { return executor_; }
+    
+    // Control-loop cycle time, published once per tick
+    CycleClock& cycleClock() { return executor_.clock(); }
+    
+    // Safe to read from any thread while the loop runs
+    const CycleInstrumentation& instrumentation() const { return instrumentation_; }
+    
+    // Per-cycle scratch for stages that need temporaries (control thread)
+    CycleArena& cycleArena() { return cycle_arena_; }
+    
+    const EmergencyStop& emergencyStop() const { return derived().estop_; }
+    const SafetyWatchdog& watchdog() const { return derived().watchdog_; }
+    
+    void stop() {
+        derived().watchdog_.disarm();
+        is_running_ = false;
+        executor_.stop();
+    }
+
+protected:
+    int64_t controlPeriodNs() const {
+        return static_cast<int64_t>(1e9 / control_frequency_);
+    }
+    
+    static int64_t periodNs(double rate_hz) {
+        return static_cast<int64_t>(std::llround(1e9 / rate_hz));
+    }
+    
+    static RateMonotonicScheduler::TaskSpec stageTask(const char* name, const StageTiming& timing,
+                                                      CycleInstrumentation::Stage stage) {
+        return {name, periodNs(timing.rate_hz), timing.phase_ns, timing.budget_ns, stage};
+    }
+    
+    // A stage that runs once per control period, on the control ticks
+    RateMonotonicScheduler::TaskSpec controlTask(const char* name, int64_t budget_ns,
+                                                 CycleInstrumentation::Stage stage) const {
+        return {name, controlPeriodNs(), 0, budget_ns, stage};
+    }
+    
+    // Register every stage with the scheduler and size the executor tick.
+    // Returns false, and logs why, when the rates are not schedulable;
+    // throws std::invalid_argument when they collapse the base tick.
+    bool configureSchedule() {
+        scheduler_.clear();
+        scheduler_.setInstrumentation(&instrumentation_);
+        derived().configureStages();
+        if (!scheduler_.isSchedulable()) {
+            AsyncLogger::instance().log(LogEvent::ScheduleUnschedulable, scheduler_.utilization(),
+                                        scheduler_.utilizationBound());
+            return false;
+        }
+        
+        executor_.setPeriod(scheduler_.basePeriodNs());
+        ticks_per_control_ = static_cast<uint64_t>(controlPeriodNs() / scheduler_.basePeriodNs());
+        derived().watchdog_.setOptions(SafetyWatchdog::Options::forRates(control_frequency_,
+                                                                         rates_.safety.rate_hz));
+        return true;
+    }
+    
+    // Stage and task tables, loop and watchdog counters, and why it stopped
+    void printSummary(std::ostream& out) const {
+        const Derived& robot = derived();
+        instrumentation_.printSummary(out);
+        scheduler_.printSummary(out);
+        out << "Cycles: " << executor_.cycles()
+            << ", overruns: " << executor_.overruns()
+            << ", skipped releases: " << executor_.skippedReleases()
+            << ", max wakeup lateness: " << executor_.maxLatenessNs() / 1000 << "us\n";
+        out << "Watchdog ticks: " << robot.watchdog_.ticks()
+            << ", max heartbeat gap: " << robot.watchdog_.maxHeartbeatGapNs() / 1000 << "us"
+            << ", frames dropped by e-stop: " << robot.command_bus_.framesDropped() << "\n";
+        out << "Log records dropped: " << AsyncLogger::instance().dropped() << "\n";
+        out << "Cycle arena: peak " << cycle_arena_.peakBytes() << " of "
+            << cycle_arena_.capacity() << " bytes, overflows: " << cycle_arena_.overflows();
+        if (AllocationGuard::kEnabled) {
+            out << ", real-time allocations: " << AllocationGuard::violations();
+        }
+        out << "\n";
+        
+        if (robot.estop_.isActive()) {
+            out << "Control loop stopped due to safety emergency:";
+            EmergencyStop::printReasons(out, robot.estop_.reasons());
+            out << "\n";
+        } else {
+            out << "Control loop stopped normally.\n";
+        }
+    }
+};
+
+#endif  // HUMANOID_CONTROL_CONTROL_LOOP_HPP
@@ -0,0 +1,188 @@
+// Includes, platform detection, time utilities and the cycle clock
+
+#ifndef HUMANOID_CONTROL_CORE_HPP
+#define HUMANOID_CONTROL_CORE_HPP
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <string>
+#include <cmath>
+#include <cstdint>
+#include <algorithm>
+#include <stdexcept>
+#include <cerrno>
+#include <new>
+#include <cstring>
+#include <atomic>
+#include <ctime>
+#include <fstream>
+#include <array>
+#include <type_traits>
+#include <ostream>
+#include <memory>
+#include <memory_resource>
+#include <functional>
+#include <numeric>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <malloc.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define HUMANOID_HAVE_AVX2_KERNELS 1
+#endif
+
+// Utility functions for time measurement
+namespace Utils {
+    void sleep_for(double seconds);
+
+    // Busy-wait hint for spin loops
+    inline void cpu_relax() {
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+        __builtin_ia32_pause();
+#endif
+    }
+}
+
+// Simulated time shared by every clock and delay line in one simulation.
+// It only moves when a sleeper asks for a later time, so a loop driven by it
+// runs as fast as the CPU allows and the same inputs give the same
+// timeline on every run.
+class VirtualTime {
+private:
+    std::atomic<int64_t> now_ns_;
+
+public:
+    explicit VirtualTime(int64_t start_ns = 0) : now_ns_(start_ns) {}
+    
+    int64_t nowNs() const { return now_ns_.load(std::memory_order_acquire); }
+    
+    // Never moves backwards
+    void advanceTo(int64_t t_ns) {
+        int64_t now = now_ns_.load(std::memory_order_relaxed);
+        while (now < t_ns &&
+               !now_ns_.compare_exchange_weak(now, t_ns, std::memory_order_acq_rel)) {
+        }
+    }
+};
+
+// Cycle time service. The scheduler samples the clock once per tick and
+// everything in that tick (sensor models, timestamps, controllers) uses the
+// same value instead of reading the clock itself. Times are integer
+// nanoseconds on the steady_clock timeline. The sample can come from
+// steady_clock, from the TSC calibrated against steady_clock once, or from
+// a VirtualTime. The clock is also the scheduler's sleeper: sleepUntil()
+// blocks on real time, or just advances virtual time.
+class CycleClock {
+public:
+    enum class Source { SteadyClock, Tsc, Virtual };
+
+private:
+    Source source_;
+    int64_t tsc_base_ns_;
+    uint64_t tsc_base_;
+    double ns_per_tsc_tick_;
+    VirtualTime* virtual_time_;
+    std::atomic<int64_t> published_ns_;
+
+public:
+    CycleClock()
+        : source_(Source::SteadyClock), tsc_base_ns_(0), tsc_base_(0),
+          ns_per_tsc_tick_(0.0), virtual_time_(nullptr), published_ns_(0) {}
+    
+    // Switch to the TSC; falls back to steady_clock where it is unavailable.
+    // Calibration blocks for calibration_ns.
+    bool useTsc(int64_t calibration_ns = 20000000) {
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+        const int64_t start_ns = steadyNowNs();
+        const uint64_t start_tsc = __builtin_ia32_rdtsc();
+        std::this_thread::sleep_for(std::chrono::nanoseconds(calibration_ns));
+        const int64_t end_ns = steadyNowNs();
+        const uint64_t end_tsc = __builtin_ia32_rdtsc();
+        if (end_tsc <= start_tsc) return false;
+        
+        ns_per_tsc_tick_ = static_cast<double>(end_ns - start_ns) / static_cast<double>(end_tsc - start_tsc);
+        tsc_base_ns_ = end_ns;
+        tsc_base_ = end_tsc;
+        source_ = Source::Tsc;
+        return true;
+#else
+        (void)calibration_ns;
+        return false;
+#endif
+    }
+    
+    // Follow simulated time instead of a hardware clock
+    void useVirtual(VirtualTime* time) {
+        virtual_time_ = time;
+        source_ = Source::Virtual;
+    }
+    
+    Source source() const { return source_; }
+    bool isVirtual() const { return source_ == Source::Virtual; }
+    VirtualTime* virtualTime() const { return virtual_time_; }
+    
+    // Read the clock; called once per tick by the scheduler
+    int64_t sample() const {
+        if (source_ == Source::Virtual) {
+            return virtual_time_->nowNs();
+        }
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+        if (source_ == Source::Tsc) {
+            const uint64_t ticks = __builtin_ia32_rdtsc() - tsc_base_;
+            return tsc_base_ns_ + static_cast<int64_t>(ticks * ns_per_tsc_tick_);
+        }
+#endif
+        return steadyNowNs();
+    }
+    
+    // Wait for an absolute time on this clock's timeline. Real clocks sleep
+    // until spin_ns before the deadline and busy-wait the rest. The sleep is
+    // on CLOCK_MONOTONIC, but the spin reads this clock's own source, so a
+    // TSC clock returns once its own sample() has reached the deadline.
+    void sleepUntil(int64_t deadline_ns, int64_t spin_ns = 0) const {
+        if (source_ == Source::Virtual) {
+            virtual_time_->advanceTo(deadline_ns);
+            return;
+        }
+        const int64_t wake_ns = deadline_ns - spin_ns;
+#ifdef __linux__
+        // steady_clock is CLOCK_MONOTONIC on Linux
+        timespec ts;
+        ts.tv_sec = static_cast<time_t>(wake_ns / 1000000000);
+        ts.tv_nsec = static_cast<long>(wake_ns % 1000000000);
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR) {
+        }
+#else
+        std::this_thread::sleep_until(std::chrono::steady_clock::time_point(
+            std::chrono::nanoseconds(wake_ns)));
+#endif
+        while (spin_ns > 0 && sample() < deadline_ns) {
+            Utils::cpu_relax();     // Spin through the final stretch
+        }
+    }
+    
+    // Latest tick time, readable from any thread
+    void publish(int64_t now_ns) { published_ns_.store(now_ns, std::memory_order_release); }
+    int64_t nowNs() const { return published_ns_.load(std::memory_order_acquire); }
+    double nowSeconds() const { return nowNs() * 1e-9; }
+    
+    static int64_t steadyNowNs() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+};
+
+#endif  // HUMANOID_CONTROL_CORE_HPP
@@ -0,0 +1,161 @@
+// Periodic executor with absolute deadlines
+
+#ifndef HUMANOID_CONTROL_EXECUTOR_HPP
+#define HUMANOID_CONTROL_EXECUTOR_HPP
+
+#include "humanoid_control/core.hpp"
+
+// Periodic executor with absolute deadlines. Each release time is computed
+// from the start time and the period, so wakeup error never accumulates.
+// The final stretch before a deadline can optionally be spun to avoid OS
+// wakeup slop. Overruns are counted, never printed. Sleeping goes through
+// the executor's CycleClock, so on virtual time the loop never blocks.
+// stop() is sticky: a stop that lands before run() starts, e.g. while a
+// new thread is still setting itself up, makes run() return at once.
+class PeriodicExecutor {
+public:
+    enum class OverrunPolicy {
+        Skip,       // Drop missed releases and realign to the next period boundary
+        CatchUp,    // Run missed releases back-to-back until on schedule again
+        Degrade     // Stretch the period (up to a limit) until the load drops
+    };
+    
+    struct Options {
+        int64_t spin_ns = 0;                // Busy-wait for this long before a deadline
+        OverrunPolicy policy = OverrunPolicy::Skip;
+        int max_degrade_factor = 4;         // Degrade: longest period is base * factor
+        int recovery_cycles = 100;          // Degrade: on-time cycles before speeding up
+    };
+    
+    struct TickInfo {
+        uint64_t cycle;
+        int64_t release_ns;     // Scheduled (absolute) release time
+        int64_t wake_ns;        // Cycle time: the one clock sample for this tick
+        int64_t period_ns;      // Current period, longer than nominal when degraded
+        uint64_t missed;        // Releases skipped right before this one
+    };
+
+private:
+    int64_t period_ns_;
+    Options options_;
+    std::atomic<bool> running_;         // Inside run()
+    std::atomic<bool> stop_requested_;  // Set by stop(), cleared only by rearm()
+    std::atomic<uint64_t> cycles_;
+    std::atomic<uint64_t> overruns_;
+    std::atomic<uint64_t> skipped_releases_;
+    std::atomic<int64_t> max_lateness_ns_;
+    std::atomic<int> degrade_factor_;
+    CycleClock clock_;
+
+public:
+    explicit PeriodicExecutor(int64_t period_ns) : PeriodicExecutor(period_ns, Options{}) {}
+    
+    PeriodicExecutor(int64_t period_ns, const Options& options)
+        : period_ns_(period_ns), options_(options), running_(false), stop_requested_(false),
+          cycles_(0), overruns_(0), skipped_releases_(0), max_lateness_ns_(0),
+          degrade_factor_(1) {
+        if (period_ns_ <= 0) {
+            throw std::invalid_argument("PeriodicExecutor: period must be positive");
+        }
+    }
+    
+    void setOptions(const Options& options) { options_ = options; }
+    const Options& options() const { return options_; }
+    int64_t periodNs() const { return period_ns_; }
+    
+    // Change the nominal period; call before run()
+    void setPeriod(int64_t period_ns) {
+        if (period_ns <= 0) {
+            throw std::invalid_argument("PeriodicExecutor: period must be positive");
+        }
+        period_ns_ = period_ns;
+    }
+    
+    // Run task(const TickInfo&) -> bool every period until it returns false
+    // or stop() is called, including a stop() from before run() started
+    template <typename Task>
+    void run(Task&& task) {
+        running_ = true;
+        int64_t release = clock_.sample() + period_ns_;
+        int on_time_streak = 0;
+        uint64_t missed = 0;
+        
+        while (!stop_requested_.load(std::memory_order_acquire)) {
+            clock_.sleepUntil(release, options_.spin_ns);
+            
+            const int factor = degrade_factor_.load(std::memory_order_relaxed);
+            TickInfo tick{cycles_.load(std::memory_order_relaxed), release,
+                          clock_.sample(), period_ns_ * factor, missed};
+            clock_.publish(tick.wake_ns);
+            const int64_t lateness = tick.wake_ns - release;
+            if (lateness > max_lateness_ns_.load(std::memory_order_relaxed)) {
+                max_lateness_ns_.store(lateness, std::memory_order_relaxed);
+            }
+            
+            if (!task(static_cast<const TickInfo&>(tick))) {
+                break;
+            }
+            cycles_.fetch_add(1, std::memory_order_relaxed);
+            missed = 0;
+            
+            int64_t next = release + tick.period_ns;
+            const int64_t now = clock_.sample();
+            if (now <= next) {
+                if (++on_time_streak >= options_.recovery_cycles && factor > 1) {
+                    degrade_factor_.store(factor / 2, std::memory_order_relaxed);
+                    on_time_streak = 0;
+                }
+                release = next;
+                continue;
+            }
+            
+            // Overrun: the task finished after its next release time
+            overruns_.fetch_add(1, std::memory_order_relaxed);
+            on_time_streak = 0;
+            switch (options_.policy) {
+            case OverrunPolicy::CatchUp:
+                break;
+            case OverrunPolicy::Degrade:
+                if (factor < options_.max_degrade_factor) {
+                    degrade_factor_.store(std::min(factor * 2, options_.max_degrade_factor),
+                                          std::memory_order_relaxed);
+                    break;
+                }
+                // Already at the slowest rate: realign like Skip
+                [[fallthrough]];
+            case OverrunPolicy::Skip:
+                missed = static_cast<uint64_t>((now - next) / tick.period_ns) + 1;
+                next += static_cast<int64_t>(missed) * tick.period_ns;
+                skipped_releases_.fetch_add(missed, std::memory_order_relaxed);
+                break;
+            }
+            release = next;
+        }
+        running_ = false;
+    }
+    
+    void stop() { stop_requested_.store(true, std::memory_order_release); }
+    bool stopRequested() const { return stop_requested_.load(std::memory_order_acquire); }
+    bool isRunning() const { return running_; }
+    
+    // Forget an earlier stop() so run() can be called again. Call it before
+    // starting the thread that calls run(), never from that thread, or a
+    // stop() issued in between is lost.
+    void rearm() { stop_requested_.store(false, std::memory_order_release); }
+    
+    uint64_t cycles() const { return cycles_.load(std::memory_order_relaxed); }
+    uint64_t overruns() const { return overruns_.load(std::memory_order_relaxed); }
+    uint64_t skippedReleases() const { return skipped_releases_.load(std::memory_order_relaxed); }
+    int64_t maxLatenessNs() const { return max_lateness_ns_.load(std::memory_order_relaxed); }
+    int degradeFactor() const { return degrade_factor_.load(std::memory_order_relaxed); }
+    
+    // Per-tick time source; useTsc()/useVirtual() must be called before run()
+    CycleClock& clock() { return clock_; }
+    const CycleClock& clock() const { return clock_; }
+    
+    static int64_t monotonicNowNs() {
+        return CycleClock::steadyNowNs();
+    }
+};
+
+#endif  // HUMANOID_CONTROL_EXECUTOR_HPP
@@ -0,0 +1,400 @@
+// Sensor fusion and the balance EKF
+
+#ifndef HUMANOID_CONTROL_FUSION_HPP
+#define HUMANOID_CONTROL_FUSION_HPP
+
+#include "humanoid_control/core.hpp"
+#include "humanoid_control/state.hpp"
+#include "humanoid_control/sensors.hpp"
+
+// Read-only, non-owning view over contiguous elements
+template <typename T>
+class ArrayView {
+private:
+    const T* data_;
+    size_t size_;
+
+public:
+    ArrayView(const T* data, size_t size) : data_(data), size_(size) {}
+    
+    const T& operator[](size_t i) const { return data_[i]; }
+    const T* begin() const { return data_; }
+    const T* end() const { return data_ + size_; }
+    const T* data() const { return data_; }
+    size_t size() const { return size_; }
+};
+
+// Fixed-size row-major matrix. Dimensions are template parameters, so all
+// storage is on the stack and every loop has a compile-time trip count the
+// compiler can fully unroll.
+template <size_t R, size_t C>
+struct FixedMatrix {
+    std::array<double, R * C> m{};
+    
+    double& operator()(size_t r, size_t c) { return m[r * C + c]; }
+    double operator()(size_t r, size_t c) const { return m[r * C + c]; }
+    
+    static FixedMatrix identity() {
+        static_assert(R == C, "identity requires a square matrix");
+        FixedMatrix out;
+        for (size_t i = 0; i < R; ++i) out(i, i) = 1.0;
+        return out;
+    }
+    
+    FixedMatrix<C, R> transpose() const {
+        FixedMatrix<C, R> out;
+        for (size_t r = 0; r < R; ++r)
+            for (size_t c = 0; c < C; ++c)
+                out(c, r) = (*this)(r, c);
+        return out;
+    }
+    
+    FixedMatrix operator+(const FixedMatrix& other) const {
+        FixedMatrix out;
+        for (size_t i = 0; i < R * C; ++i) out.m[i] = m[i] + other.m[i];
+        return out;
+    }
+    
+    FixedMatrix operator-(const FixedMatrix& other) const {
+        FixedMatrix out;
+        for (size_t i = 0; i < R * C; ++i) out.m[i] = m[i] - other.m[i];
+        return out;
+    }
+    
+    template <size_t K>
+    FixedMatrix<R, K> operator*(const FixedMatrix<C, K>& other) const {
+        FixedMatrix<R, K> out;
+        for (size_t r = 0; r < R; ++r)
+            for (size_t k = 0; k < C; ++k) {
+                const double a = (*this)(r, k);
+                for (size_t c = 0; c < K; ++c)
+                    out(r, c) += a * other(k, c);
+            }
+        return out;
+    }
+};
+
+template <size_t N>
+using FixedVector = FixedMatrix<N, 1>;
+
+// Inverse of a symmetric positive definite matrix via Cholesky
+// factorization. Returns false if the matrix is not positive definite.
+template <size_t N>
+bool invertSpd(const FixedMatrix<N, N>& a, FixedMatrix<N, N>& inverse) {
+    FixedMatrix<N, N> l;
+    for (size_t j = 0; j < N; ++j) {
+        double d = a(j, j);
+        for (size_t k = 0; k < j; ++k) d -= l(j, k) * l(j, k);
+        if (d <= 0.0) return false;
+        l(j, j) = std::sqrt(d);
+        for (size_t i = j + 1; i < N; ++i) {
+            double v = a(i, j);
+            for (size_t k = 0; k < j; ++k) v -= l(i, k) * l(j, k);
+            l(i, j) = v / l(j, j);
+        }
+    }
+    // Solve L L^T X = I one column at a time
+    for (size_t c = 0; c < N; ++c) {
+        double y[N];
+        for (size_t i = 0; i < N; ++i) {
+            double v = (i == c) ? 1.0 : 0.0;
+            for (size_t k = 0; k < i; ++k) v -= l(i, k) * y[k];
+            y[i] = v / l(i, i);
+        }
+        for (size_t i = N; i-- > 0;) {
+            double v = y[i];
+            for (size_t k = i + 1; k < N; ++k) v -= l(k, i) * inverse(k, c);
+            inverse(i, c) = v / l(i, i);
+        }
+    }
+    return true;
+}
+
+// Extended Kalman filter core with a compile-time state dimension. The
+// model supplies the predicted state, Jacobians and noise; no heap use.
+template <size_t N>
+class ExtendedKalmanFilter {
+public:
+    using State = FixedVector<N>;
+    using Covariance = FixedMatrix<N, N>;
+
+private:
+    State x_;
+    Covariance p_;
+
+public:
+    ExtendedKalmanFilter() : p_(Covariance::identity()) {}
+    
+    void reset(const State& x, const Covariance& p) {
+        x_ = x;
+        p_ = p;
+    }
+    
+    // x = f(x), P = F P F^T + Q
+    void predict(const State& x_predicted, const Covariance& f, const Covariance& q) {
+        x_ = x_predicted;
+        p_ = f * p_ * f.transpose() + q;
+    }
+    
+    // Standard EKF update with measurement z, predicted measurement h(x),
+    // Jacobian H and measurement noise R. Returns false if S is singular.
+    template <size_t M>
+    bool update(const FixedVector<M>& z, const FixedVector<M>& hx,
+                const FixedMatrix<M, N>& h, const FixedMatrix<M, M>& r) {
+        const FixedMatrix<N, M> pht = p_ * h.transpose();
+        const FixedMatrix<M, M> innovation_cov = h * pht + r;
+        FixedMatrix<M, M> s_inv;
+        if (!invertSpd(innovation_cov, s_inv)) return false;
+        
+        const FixedMatrix<N, M> k = pht * s_inv;
+        x_ = x_ + k * (z - hx);
+        // Joseph form keeps P symmetric positive definite
+        const Covariance i_kh = Covariance::identity() - k * h;
+        p_ = i_kh * p_ * i_kh.transpose() + k * r * k.transpose();
+        return true;
+    }
+    
+    const State& state() const { return x_; }
+    const Covariance& covariance() const { return p_; }
+    double& state(size_t i) { return x_(i, 0); }
+    double state(size_t i) const { return x_(i, 0); }
+};
+
+// Balance estimator: torso roll/pitch, gyro bias and the hip-angle offset.
+// The gyro drives the prediction with the real sample interval; the
+// accelerometer (gravity direction) and the hip encoders are measurements.
+class BalanceEkf {
+public:
+    enum StateIndex { Roll, Pitch, BiasX, BiasY, HipOffset, kStateSize };
+    using Filter = ExtendedKalmanFilter<kStateSize>;
+
+private:
+    static constexpr double kGravity = 9.81;
+    
+    Filter filter_;
+    int64_t last_time_ns_;
+    bool initialized_;              // last_time_ns_ holds a sample time
+    double gyro_x_, gyro_y_;        // Held between IMU samples
+    
+    // Process noise densities (per second) and measurement noise
+    double attitude_noise_;
+    double bias_noise_;
+    double hip_offset_noise_;
+    double accel_noise_;
+    double hip_noise_;
+
+public:
+    BalanceEkf()
+        : last_time_ns_(0), initialized_(false), gyro_x_(0.0), gyro_y_(0.0),
+          attitude_noise_(1e-4), bias_noise_(1e-7), hip_offset_noise_(1e-5),
+          accel_noise_(0.05), hip_noise_(0.01) {
+        Filter::Covariance p;
+        p(Roll, Roll) = p(Pitch, Pitch) = 0.1;
+        p(BiasX, BiasX) = p(BiasY, BiasY) = 0.01;
+        p(HipOffset, HipOffset) = 0.1;
+        filter_.reset(Filter::State(), p);
+    }
+    
+    // Gyro + accelerometer sample from the attitude IMU
+    void updateImu(const double angular_velocity[3], const double linear_acceleration[3],
+                   int64_t timestamp_ns) {
+        advanceTo(timestamp_ns);
+        gyro_x_ = angular_velocity[0];
+        gyro_y_ = angular_velocity[1];
+        
+        // Specific force at rest: g * [-sin(p), sin(r)cos(p), cos(r)cos(p)]
+        const double roll = filter_.state(Roll);
+        const double pitch = filter_.state(Pitch);
+        const double sr = std::sin(roll), cr = std::cos(roll);
+        const double sp = std::sin(pitch), cp = std::cos(pitch);
+        
+        FixedVector<3> z, hx;
+        z(0, 0) = linear_acceleration[0];
+        z(1, 0) = linear_acceleration[1];
+        z(2, 0) = linear_acceleration[2];
+        hx(0, 0) = -kGravity * sp;
+        hx(1, 0) = kGravity * sr * cp;
+        hx(2, 0) = kGravity * cr * cp;
+        
+        FixedMatrix<3, kStateSize> h;
+        h(0, Pitch) = -kGravity * cp;
+        h(1, Roll) = kGravity * cr * cp;
+        h(1, Pitch) = -kGravity * sr * sp;
+        h(2, Roll) = -kGravity * sr * cp;
+        h(2, Pitch) = -kGravity * cr * sp;
+        
+        FixedMatrix<3, 3> r;
+        r(0, 0) = r(1, 1) = r(2, 2) = accel_noise_;
+        filter_.update(z, hx, h, r);
+    }
+    
+    // Hip encoder angle, modelled as torso roll plus a slowly varying offset
+    void updateHip(double hip_position, int64_t timestamp_ns) {
+        advanceTo(timestamp_ns);
+        
+        FixedVector<1> z, hx;
+        z(0, 0) = hip_position;
+        hx(0, 0) = filter_.state(Roll) + filter_.state(HipOffset);
+        
+        FixedMatrix<1, kStateSize> h;
+        h(0, Roll) = 1.0;
+        h(0, HipOffset) = 1.0;
+        
+        FixedMatrix<1, 1> r;
+        r(0, 0) = hip_noise_;
+        filter_.update(z, hx, h, r);
+    }
+    
+    double roll() const { return filter_.state(Roll); }
+    double pitch() const { return filter_.state(Pitch); }
+    double rollVariance() const { return filter_.covariance()(Roll, Roll); }
+    const Filter& filter() const { return filter_; }
+
+private:
+    // Propagate attitude to the measurement time with the last gyro sample.
+    // Samples older than the filter time are applied without prediction.
+    void advanceTo(int64_t timestamp_ns) {
+        // Any time is valid, including 0 at the start of virtual time
+        if (!initialized_) {
+            last_time_ns_ = timestamp_ns;
+            initialized_ = true;
+            return;
+        }
+        if (timestamp_ns <= last_time_ns_) return;
+        const double dt = (timestamp_ns - last_time_ns_) * 1e-9;
+        last_time_ns_ = timestamp_ns;
+        
+        Filter::State x = filter_.state();
+        x(Roll, 0) += (gyro_x_ - x(BiasX, 0)) * dt;
+        x(Pitch, 0) += (gyro_y_ - x(BiasY, 0)) * dt;
+        
+        Filter::Covariance f = Filter::Covariance::identity();
+        f(Roll, BiasX) = -dt;
+        f(Pitch, BiasY) = -dt;
+        
+        Filter::Covariance q;
+        q(Roll, Roll) = q(Pitch, Pitch) = attitude_noise_ * dt;
+        q(BiasX, BiasX) = q(BiasY, BiasY) = bias_noise_ * dt;
+        q(HipOffset, HipOffset) = hip_offset_noise_ * dt;
+        filter_.predict(x, f, q);
+    }
+};
+
+// Sensor fusion class using Kalman filter concepts. Joints and IMUs are
+// registered once at startup and addressed by dense integer handles; all
+// storage is flat arrays. Balance comes from BalanceEkf. Updates come from
+// the control thread only; the balance estimate is published atomically
+// for other threads.
+class SensorFusion {
+public:
+    using JointHandle = uint32_t;
+    using ImuHandle = uint32_t;
+
+private:
+    std::vector<std::string> joint_names_;
+    std::vector<JointState> joint_states_;
+    std::vector<uint8_t> joint_is_hip_;     // Classified once at registration
+    std::vector<uint8_t> joint_fresh_;      // Stored since the last updateBalance()
+    
+    std::vector<std::string> imu_names_;
+    std::vector<ImuData> imu_data_;
+    std::vector<uint8_t> imu_is_torso_;     // Attitude source for the EKF
+    std::vector<uint8_t> imu_fresh_;
+    
+    // Torso attitude / gyro bias / hip coupling estimator
+    BalanceEkf balance_ekf_;
+    std::atomic<double> published_balance_;
+
+public:
+    SensorFusion() : published_balance_(0.0) {}
+    
+    // Registration (startup only; may allocate)
+    JointHandle registerJoint(const std::string& joint_name) {
+        joint_names_.push_back(joint_name);
+        joint_states_.emplace_back();
+        joint_is_hip_.push_back(joint_name.find("hip") != std::string::npos);
+        joint_fresh_.push_back(0);
+        return static_cast<JointHandle>(joint_names_.size() - 1);
+    }
+    
+    ImuHandle registerImu(const std::string& sensor_name) {
+        imu_names_.push_back(sensor_name);
+        imu_data_.emplace_back();
+        imu_is_torso_.push_back(sensor_name.find("torso") != std::string::npos);
+        imu_fresh_.push_back(0);
+        return static_cast<ImuHandle>(imu_names_.size() - 1);
+    }
+    
+    void updateJointState(JointHandle joint, const JointState& state) {
+        joint_states_[joint] = state;
+        
+        // Hip joint angles constrain torso roll through the hip offset
+        if (joint_is_hip_[joint]) {
+            balance_ekf_.updateHip(state.position, state.timestamp_ns);
+            published_balance_.store(balance_ekf_.roll(), std::memory_order_relaxed);
+        }
+    }
+    
+    void updateImuData(ImuHandle imu, const ImuData& data) {
+        imu_data_[imu] = data;
+        
+        // Torso gyro predicts attitude, its accelerometer corrects it
+        if (imu_is_torso_[imu]) {
+            balance_ekf_.updateImu(data.angular_velocity, data.linear_acceleration,
+                                   data.timestamp_ns);
+            published_balance_.store(balance_ekf_.roll(), std::memory_order_relaxed);
+        }
+    }
+    
+    // Store-only updates, for loops that run the balance filter as its own
+    // stage at a lower rate than the sensors
+    void storeJointState(JointHandle joint, const JointState& state) {
+        joint_states_[joint] = state;
+        joint_fresh_[joint] = 1;
+    }
+    
+    void storeImuData(ImuHandle imu, const ImuData& data) {
+        imu_data_[imu] = data;
+        imu_fresh_[imu] = 1;
+    }
+    
+    // Run the balance EKF on the newest torso IMU and hip samples stored
+    // since the last call. Older samples in between are decimated; the
+    // gyro rate is held over the whole interval.
+    void updateBalance() {
+        for (size_t i = 0; i < imu_data_.size(); ++i) {
+            if (imu_fresh_[i] && imu_is_torso_[i]) {
+                const ImuData& data = imu_data_[i];
+                balance_ekf_.updateImu(data.angular_velocity, data.linear_acceleration,
+                                       data.timestamp_ns);
+            }
+            imu_fresh_[i] = 0;
+        }
+        for (size_t j = 0; j < joint_states_.size(); ++j) {
+            if (joint_fresh_[j] && joint_is_hip_[j]) {
+                balance_ekf_.updateHip(joint_states_[j].position, joint_states_[j].timestamp_ns);
+            }
+            joint_fresh_[j] = 0;
+        }
+        published_balance_.store(balance_ekf_.roll(), std::memory_order_relaxed);
+    }
+    
+    double getBalanceEstimate() const {
+        return published_balance_.load(std::memory_order_relaxed);
+    }
+    
+    // Zero-copy views, indexed by handle (control thread only)
+    ArrayView<JointState> getJointStates() const {
+        return ArrayView<JointState>(joint_states_.data(), joint_states_.size());
+    }
+    
+    ArrayView<ImuData> getImuData() const {
+        return ArrayView<ImuData>(imu_data_.data(), imu_data_.size());
+    }
+    
+    const std::string& jointName(JointHandle joint) const { return joint_names_[joint]; }
+    const std::string& imuName(ImuHandle imu) const { return imu_names_[imu]; }
+    const BalanceEkf& balanceFilter() const { return balance_ekf_; }
+};
+
+#endif  // HUMANOID_CONTROL_FUSION_HPP
@@ -0,0 +1,29 @@
+// Everything in the humanoid_control library. Include the individual
+// headers instead to pull in less.
+
+#ifndef HUMANOID_CONTROL_HUMANOID_CONTROL_HPP
+#define HUMANOID_CONTROL_HUMANOID_CONTROL_HPP
+
+#include "humanoid_control/core.hpp"
+#include "humanoid_control/state.hpp"
+#include "humanoid_control/allocation.hpp"
+#include "humanoid_control/logging.hpp"
+#include "humanoid_control/sensors.hpp"
+#include "humanoid_control/actuation.hpp"
+#include "humanoid_control/joint_control.hpp"
+#include "humanoid_control/fusion.hpp"
+#include "humanoid_control/safety_monitor.hpp"
+#include "humanoid_control/executor.hpp"
+#include "humanoid_control/acquisition.hpp"
+#include "humanoid_control/instrumentation.hpp"
+#include "humanoid_control/scheduler.hpp"
+#include "humanoid_control/control_loop.hpp"
+#include "humanoid_control/telemetry.hpp"
+#include "humanoid_control/rt_setup.hpp"
+#include "humanoid_control/safety_watchdog.hpp"
+#include "humanoid_control/humanoid_controller.hpp"
+#include "humanoid_control/replay.hpp"
+#include "humanoid_control/sweep.hpp"
+#include "humanoid_control/static_controller.hpp"
+
+#endif  // HUMANOID_CONTROL_HUMANOID_CONTROL_HPP
@@ -0,0 +1,236 @@
+// Main humanoid robot controller
+
+#ifndef HUMANOID_CONTROL_HUMANOID_CONTROLLER_HPP
+#define HUMANOID_CONTROL_HUMANOID_CONTROLLER_HPP
+
+#include "humanoid_control/core.hpp"
+#include "humanoid_control/state.hpp"
+#include "humanoid_control/logging.hpp"
+#include "humanoid_control/sensors.hpp"
+#include "humanoid_control/actuation.hpp"
+#include "humanoid_control/joint_control.hpp"
+#include "humanoid_control/fusion.hpp"
+#include "humanoid_control/safety_monitor.hpp"
+#include "humanoid_control/acquisition.hpp"
+#include "humanoid_control/telemetry.hpp"
+#include "humanoid_control/control_loop.hpp"
+
+// Main humanoid robot controller, for any number of joints chosen at run
+// time. Each pipeline stage is a task on the ControlLoop's rate-monotonic
+// scheduler, so sensors, fusion, control and safety each run at their own
+// rate; sensors are read on acquisition threads unless on virtual time.
+class HumanoidController : public ControlLoop<HumanoidController> {
+    friend class ControlLoop<HumanoidController>;
+    
+    // Contiguous per-joint state shared by controllers, fusion and safety
+    JointStateBank joint_state_bank_;
+    
+    // Batched PID state for all joints and the kernel that sweeps it
+    PidBank pid_bank_;
+    PidKernel pid_kernel_;
+    AlignedArray<double> torque_commands_;
+    SafetyLimits safety_limits_;
+    
+    // Deques keep element addresses stable for the raw pointers handed to
+    // SafetyMonitor and CommandBus
+    std::deque<JointController> joint_controllers_;
+    std::deque<JointSensor> joint_sensors_;
+    std::deque<ImuSensor> imu_sensors_;
+    
+    // Declared after the sensors so its threads stop before they go away
+    SensorAcquisition acquisition_;
+    bool threaded_acquisition_;
+    
+    SensorFusion sensor_fusion_;
+    std::vector<SensorFusion::JointHandle> fusion_joints_;  // By joint index
+    std::vector<SensorFusion::ImuHandle> fusion_imus_;      // By IMU index
+    EmergencyStop estop_;
+    SafetyMonitor safety_monitor_;
+    CommandBus command_bus_;  // Declared after the joints so it stops first
+    SafetyWatchdog watchdog_; // Declared after the bus so it stops first
+    
+    TelemetryRecorder telemetry_;
+    TelemetryRecorder::Options telemetry_options_;
+    bool telemetry_enabled_;
+    
+public:
+    // Robot joints (simplified - just 6 for example)
+    static std::vector<std::string> defaultJointNames();
+    
+    HumanoidController(double frequency = 100.0)  // 100Hz by default
+        : HumanoidController(frequency, defaultJointNames()) {}
+    
+    // Any number of joints; the status line shows joints 0 and 3
+    HumanoidController(double frequency, const std::vector<std::string>& joint_names);
+    
+    // Drain the acquisition rings into the state bank and sensor fusion;
+    // the balance filter runs separately in SensorFusion::updateBalance()
+    void drainSensors() {
+        drainJoints();
+        drainImus();
+    }
+    
+    // Read sensors on dedicated threads (default) or inline on the control
+    // thread; on virtual time they are always read inline
+    void setThreadedAcquisition(bool threaded) {
+        threaded_acquisition_ = threaded;
+    }
+    
+    // Tuning hooks, for every joint; call before run() or beginSimulation()
+    void setGains(double kp, double ki, double kd) {
+        for (size_t j = 0; j < joint_controllers_.size(); ++j) {
+            pid_bank_.kp[j] = kp;
+            pid_bank_.ki[j] = ki;
+            pid_bank_.kd[j] = kd;
+        }
+    }
+    
+    void setNoiseLevel(double sigma) {
+        NoiseModel model;
+        model.white_sigma = sigma;
+        for (auto& sensor : joint_sensors_) {
+            sensor.setNoiseModel(model);
+        }
+        for (auto& sensor : imu_sensors_) {
+            sensor.setNoiseModel(model);
+        }
+        acquisition_.seedJointNoise(acquisition_.noiseSeed());
+    }
+    
+    // Velocity limit for both the PID derating and the safety check
+    void setVelocityLimit(double limit) {
+        for (size_t j = 0; j < joint_controllers_.size(); ++j) {
+            pid_bank_.max_velocity[j] = limit;
+            safety_limits_.max_velocity[j] = limit;
+        }
+    }
+    
+    void setTargetPosition(size_t joint, double position) {
+        joint_controllers_[joint].setTargetPosition(position);
+    }
+    
+    JointSensor& jointSensor(size_t joint) { return joint_sensors_[joint]; }
+    double appliedTorque(size_t joint) const {
+        return joint_controllers_[joint].getActuator().getTorque();
+    }
+    const double* jointTargets() const { return pid_bank_.target.data(); }
+    
+    // Offline replay: enable the controllers without starting the bus,
+    // acquisition, watchdog or executor. Cycles are then driven one at a
+    // time by replayCycle() on virtual time.
+    bool beginReplay();
+    
+    // Feed one recorded cycle through fusion, control and safety, in stage
+    // order and without the scheduler: the log holds one frame per control
+    // period. The virtual clock is the recorded cycle time; nothing sleeps.
+    // Returns false once the controller has stopped (e.g. e-stop).
+    bool replayCycle(const TelemetryFrame& frame) {
+        for (size_t j = 0; j < frame.joints.size() && j < joint_controllers_.size(); ++j) {
+            acquisition_.pushJoint(JointSample{static_cast<uint32_t>(j), frame.joints[j]});
+        }
+        for (size_t i = 0; i < frame.imus.size() && i < imu_sensors_.size(); ++i) {
+            acquisition_.pushImu(ImuSample{static_cast<uint32_t>(i), frame.imus[i]});
+        }
+        if (!is_running_ || estop_.isActive()) {
+            return false;
+        }
+        const Tick tick{frame.cycle, frame.time_ns, frame.time_ns, controlPeriodNs(), 0};
+        cycle_arena_.reset();
+        drainSensors();
+        sensor_fusion_.updateBalance();
+        controlStage(tick);
+        safety_monitor_.checkSafety(tick.wake_ns, cycle_arena_);
+        return true;
+    }
+    
+    size_t jointCount() const { return joint_controllers_.size(); }
+    size_t imuCount() const { return imu_sensors_.size(); }
+    const double* torqueCommands() const { return torque_commands_.data(); }
+    double balanceEstimate() const { return sensor_fusion_.getBalanceEstimate(); }
+    
+    // Record every cycle to memory-mapped segment files; opened by run()
+    void enableTelemetry(const TelemetryRecorder::Options& options) {
+        telemetry_options_ = options;
+        telemetry_enabled_ = true;
+    }
+    
+    const TelemetryRecorder& telemetry() const { return telemetry_; }
+
+private:
+    // ControlLoop hooks
+    void configureStages();
+    void primeSensors(int64_t now_ns);
+    void seedJointNoise(uint64_t seed) { acquisition_.seedJointNoise(seed); }
+    void startRun(bool simulated);
+    void finishRun();
+    
+    void logStatus(int64_t now_ns) {
+        const double* position = joint_state_bank_.position();
+        AsyncLogger::instance().log(LogEvent::Status,
+            now_ns * 1e-9,
+            position[0],    // left_hip
+            position[3],    // right_hip
+            sensor_fusion_.getBalanceEstimate(),
+            estop_.isActive() ? "EMERGENCY" : "OK");
+    }
+    
+    void openTelemetry();
+    
+    // Stages. Without acquisition threads the sensor stages also read the
+    // sensors inline; with them they only drain the rings.
+    void imuStage(const Tick& tick) {
+        if (!acquisition_.isThreaded()) {
+            acquisition_.pollImus(tick.wake_ns);
+        }
+        drainImus();
+    }
+    
+    void jointStage(const Tick& tick) {
+        if (!acquisition_.isThreaded()) {
+            acquisition_.pollJoints(tick.wake_ns);
+        }
+        drainJoints();
+    }
+    
+    // The acquisition thread reads temperatures itself when threaded
+    void temperatureStage(const Tick& tick) {
+        if (!acquisition_.isThreaded()) {
+            acquisition_.pollTemperatures(tick.wake_ns);
+        }
+    }
+    
+    // Update all controllers in one batched PID pass, then flush all staged
+    // torques in one bus transaction
+    void controlStage(const Tick& tick) {
+        pid_kernel_.step(pid_bank_, joint_state_bank_, tick.period_ns * 1e-9,
+                         torque_commands_.data());
+        for (auto& controller : joint_controllers_) {
+            controller.stageCommand(torque_commands_[controller.getJointIndex()]);
+        }
+        command_bus_.publish();
+    }
+    
+    // One record per control period
+    void telemetryStage(const Tick& tick) {
+        if (telemetry_.isOpen()) {
+            telemetry_.record(tick.cycle, tick.wake_ns, joint_state_bank_, torque_commands_.data(),
+                              sensor_fusion_.getImuData(), sensor_fusion_.getBalanceEstimate(),
+                              safety_monitor_.violationMask(), estop_.reasons());
+        }
+    }
+    
+    void drainJoints() {
+        acquisition_.drainJoints([this](const JointSample& sample) {
+            joint_state_bank_.store(sample.joint, sample.state);
+            sensor_fusion_.storeJointState(fusion_joints_[sample.joint], sample.state);
+        });
+    }
+    
+    void drainImus() {
+        acquisition_.drainImus([this](const ImuSample& sample) {
+            sensor_fusion_.storeImuData(fusion_imus_[sample.imu], sample.data);
+        });
+    }
+};
+
+#endif  // HUMANOID_CONTROL_HUMANOID_CONTROLLER_HPP
@@ -0,0 +1,149 @@
+// Per-stage cycle timing
+
+#ifndef HUMANOID_CONTROL_INSTRUMENTATION_HPP
+#define HUMANOID_CONTROL_INSTRUMENTATION_HPP
+
+#include "humanoid_control/core.hpp"
+
+// Log-bucketed latency histogram in the style of HdrHistogram: values below
+// 2^kSubBucketBits are exact, above that every power of two is split into
+// 2^kSubBucketBits linear sub-buckets (~6% relative resolution). Recording
+// is allocation-free and wait-free for a single writer; any thread can take
+// a snapshot concurrently without locking.
+class LatencyHistogram {
+public:
+    static constexpr int kSubBucketBits = 4;
+    static constexpr size_t kSubBuckets = size_t(1) << kSubBucketBits;
+    static constexpr size_t kBucketCount = kSubBuckets + (63 - kSubBucketBits) * kSubBuckets;
+    
+    struct Snapshot {
+        std::array<uint64_t, kBucketCount> counts{};
+        uint64_t count = 0;
+        int64_t max = 0;
+        
+        // Value at or below which the given fraction of samples fall
+        int64_t percentile(double fraction) const {
+            if (count == 0) return 0;
+            uint64_t rank = static_cast<uint64_t>(std::ceil(fraction * count));
+            rank = std::max<uint64_t>(rank, 1);
+            uint64_t seen = 0;
+            for (size_t i = 0; i < kBucketCount; ++i) {
+                seen += counts[i];
+                if (seen >= rank) {
+                    return std::min(bucketUpperBound(i), max);
+                }
+            }
+            return max;
+        }
+    };
+
+private:
+    std::array<std::atomic<uint64_t>, kBucketCount> counts_;
+    std::atomic<uint64_t> count_;
+    std::atomic<int64_t> max_;
+
+public:
+    LatencyHistogram() : count_(0), max_(0) {
+        for (auto& c : counts_) {
+            c.store(0, std::memory_order_relaxed);
+        }
+    }
+    
+    // Single writer: plain load/store keeps the hot path free of locked
+    // read-modify-write instructions
+    void record(int64_t value_ns) {
+        if (value_ns < 0) value_ns = 0;
+        auto& bucket = counts_[bucketIndex(static_cast<uint64_t>(value_ns))];
+        bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        count_.store(count_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        if (value_ns > max_.load(std::memory_order_relaxed)) {
+            max_.store(value_ns, std::memory_order_relaxed);
+        }
+    }
+    
+    void snapshot(Snapshot& out) const {
+        out.count = 0;
+        for (size_t i = 0; i < kBucketCount; ++i) {
+            out.counts[i] = counts_[i].load(std::memory_order_relaxed);
+            out.count += out.counts[i];
+        }
+        out.max = max_.load(std::memory_order_relaxed);
+    }
+    
+    uint64_t count() const { return count_.load(std::memory_order_relaxed); }
+    
+    static size_t bucketIndex(uint64_t value) {
+        if (value < kSubBuckets) {
+            return static_cast<size_t>(value);
+        }
+        const int msb = 63 - __builtin_clzll(value);
+        const int shift = msb - kSubBucketBits;
+        return kSubBuckets + static_cast<size_t>(shift) * kSubBuckets
+             + static_cast<size_t>((value >> shift) - kSubBuckets);
+    }
+    
+    static int64_t bucketUpperBound(size_t index) {
+        if (index < kSubBuckets) {
+            return static_cast<int64_t>(index);
+        }
+        const size_t shift = (index - kSubBuckets) / kSubBuckets;
+        const uint64_t sub = (index - kSubBuckets) % kSubBuckets + kSubBuckets;
+        return static_cast<int64_t>(((sub + 1) << shift) - 1);
+    }
+};
+
+// Per-stage timing for the control cycle: wakeup latency, each pipeline
+// stage and the whole cycle
+class CycleInstrumentation {
+public:
+    enum Stage {
+        WakeUp,
+        SensorRead,
+        Fusion,
+        Control,
+        Safety,
+        Telemetry,
+        Total,
+        kStageCount
+    };
+
+private:
+    std::array<LatencyHistogram, kStageCount> histograms_;
+
+public:
+    void record(Stage stage, int64_t duration_ns) {
+        histograms_[stage].record(duration_ns);
+    }
+    
+    const LatencyHistogram& histogram(Stage stage) const {
+        return histograms_[stage];
+    }
+    
+    static const char* stageName(Stage stage) {
+        static const char* const names[kStageCount] = {
+            "wakeup", "sensor_read", "fusion", "control", "safety", "telemetry", "total"
+        };
+        return names[stage];
+    }
+    
+    // p50/p99/p99.9/max per stage, leaving out stages the loop does not
+    // time itself; not for the real-time thread
+    void printSummary(std::ostream& out) const {
+        LatencyHistogram::Snapshot snap;
+        out << "Stage\t\tcount\tp50(us)\tp99(us)\tp99.9(us)\tmax(us)\n";
+        for (int i = 0; i < kStageCount; ++i) {
+            histograms_[i].snapshot(snap);
+            if (snap.count == 0) continue;
+            out << std::fixed << std::setprecision(2)
+                << stageName(static_cast<Stage>(i)) << "\t"
+                << (std::strlen(stageName(static_cast<Stage>(i))) < 8 ? "\t" : "")
+                << snap.count << "\t"
+                << snap.percentile(0.50) / 1000.0 << "\t"
+                << snap.percentile(0.99) / 1000.0 << "\t"
+                << snap.percentile(0.999) / 1000.0 << "\t\t"
+                << snap.max / 1000.0 << "\n";
+        }
+    }
+};
+
+#endif  // HUMANOID_CONTROL_INSTRUMENTATION_HPP
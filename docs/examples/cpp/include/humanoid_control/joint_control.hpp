@@ -0,0 +1,446 @@
+// Batched PID and safety kernels and the per-joint controller
+
+#ifndef HUMANOID_CONTROL_JOINT_CONTROL_HPP
+#define HUMANOID_CONTROL_JOINT_CONTROL_HPP
+
+#include "humanoid_control/core.hpp"
+#include "humanoid_control/state.hpp"
+#include "humanoid_control/logging.hpp"
+#include "humanoid_control/actuation.hpp"
+
+// Structure-of-arrays PID gains, targets, limits and integrator state for
+// all joints. Index j matches the JointStateBank joint index.
+struct PidBank {
+    AlignedArray<double> kp, ki, kd;
+    AlignedArray<double> target;
+    AlignedArray<double> error_sum;
+    AlignedArray<double> last_error;
+    AlignedArray<double> max_velocity;
+    AlignedArray<double> max_temperature;
+    AlignedArray<double> max_torque;
+    AlignedArray<int64_t> enabled;   // All bits set when enabled (SIMD lane mask)
+    
+    explicit PidBank(size_t joints)
+        : kp(joints), ki(joints), kd(joints), target(joints),
+          error_sum(joints), last_error(joints),
+          max_velocity(joints), max_temperature(joints), max_torque(joints),
+          enabled(joints) {}
+    
+    size_t size() const { return kp.size(); }
+    size_t paddedSize() const { return kp.capacity(); }
+};
+
+// Batched PID over all joints: error, integral, derivative, velocity and
+// temperature derating and torque clamping in one pass. The AVX2 path and
+// the scalar path perform the same IEEE operations in the same order, so
+// Mode::Verify can require bit-identical results (this needs the build to
+// leave floating-point contraction off, i.e. no implicit FMA).
+class PidKernel {
+public:
+    enum class Mode { Auto, Scalar, Verify };
+
+private:
+    Mode mode_;
+    bool use_avx2_;
+    uint64_t verify_mismatches_;
+    
+    // Verify-mode scratch, sized once at construction
+    AlignedArray<double> saved_error_sum_, saved_last_error_, saved_torque_;
+    AlignedArray<double> ref_error_sum_, ref_last_error_, ref_torque_, ref_out_;
+
+public:
+    explicit PidKernel(size_t joints, Mode mode = Mode::Auto)
+        : mode_(mode), use_avx2_(cpuHasAvx2()), verify_mismatches_(0),
+          saved_error_sum_(joints), saved_last_error_(joints), saved_torque_(joints),
+          ref_error_sum_(joints), ref_last_error_(joints), ref_torque_(joints),
+          ref_out_(joints) {}
+    
+    void setMode(Mode mode) { mode_ = mode; }
+    Mode mode() const { return mode_; }
+    bool usesAvx2() const { return use_avx2_ && mode_ != Mode::Scalar; }
+    uint64_t verifyMismatches() const { return verify_mismatches_; }
+    
+    // Run one control step for every joint. torque_out must hold
+    // bank.paddedSize() entries; disabled joints get 0 and keep their state.
+    void step(PidBank& pid, JointStateBank& state, double dt, double* torque_out) {
+        if (mode_ == Mode::Verify) {
+            stepVerify(pid, state, dt, torque_out);
+        } else if (mode_ == Mode::Auto && use_avx2_) {
+            stepAvx2(pid, state, dt, torque_out);
+        } else {
+            stepScalar(pid, state, dt, torque_out, 0, pid.size());
+        }
+    }
+    
+    // Reference implementation, also used for single-joint updates.
+    // torque_out[0] corresponds to joint 'begin'.
+    static void stepScalar(PidBank& pid, JointStateBank& state, double dt,
+                           double* torque_out, size_t begin, size_t end) {
+        const double* position = state.position();
+        const double* velocity = state.velocity();
+        const double* temperature = state.temperature();
+        double* torque = state.torque();
+        
+        for (size_t j = begin; j < end; ++j) {
+            if (!pid.enabled[j]) {
+                torque_out[j - begin] = 0.0;
+                continue;
+            }
+            double error = pid.target[j] - position[j];
+            double error_sum = pid.error_sum[j] + error * dt;
+            double error_derivative = (error - pid.last_error[j]) / dt;
+            double command = pid.kp[j] * error + pid.ki[j] * error_sum + pid.kd[j] * error_derivative;
+            
+            // Stop if velocity limit exceeded
+            if (std::fabs(velocity[j]) > pid.max_velocity[j]) {
+                command = 0.0;
+            }
+            // Reduce torque when near temperature limit
+            if (temperature[j] > pid.max_temperature[j] * 0.9) {
+                command = command * 0.5;
+            }
+            // Clamp, written to match max_pd/min_pd operand semantics
+            const double limit = pid.max_torque[j];
+            command = command > -limit ? command : -limit;
+            command = command < limit ? command : limit;
+            
+            pid.error_sum[j] = error_sum;
+            pid.last_error[j] = error;
+            torque[j] = command;
+            torque_out[j - begin] = command;
+        }
+    }
+
+#ifdef HUMANOID_HAVE_AVX2_KERNELS
+    __attribute__((target("avx2")))
+    static void stepAvx2(PidBank& pid, JointStateBank& state, double dt, double* torque_out) {
+        const double* position = state.position();
+        const double* velocity = state.velocity();
+        const double* temperature = state.temperature();
+        double* torque = state.torque();
+        
+        const __m256d vdt = _mm256_set1_pd(dt);
+        const __m256d zero = _mm256_setzero_pd();
+        const __m256d half = _mm256_set1_pd(0.5);
+        const __m256d derate = _mm256_set1_pd(0.9);
+        const __m256d sign_mask = _mm256_set1_pd(-0.0);
+        
+        // Padded lanes are disabled, so the whole padded length is safe
+        for (size_t j = 0; j < pid.paddedSize(); j += 4) {
+            const __m256d enabled = _mm256_castsi256_pd(
+                _mm256_load_si256(reinterpret_cast<const __m256i*>(&pid.enabled[j])));
+            const __m256d last_error = _mm256_load_pd(&pid.last_error[j]);
+            const __m256d old_sum = _mm256_load_pd(&pid.error_sum[j]);
+            
+            __m256d error = _mm256_sub_pd(_mm256_load_pd(&pid.target[j]),
+                                          _mm256_load_pd(&position[j]));
+            __m256d error_sum = _mm256_add_pd(old_sum, _mm256_mul_pd(error, vdt));
+            __m256d error_derivative = _mm256_div_pd(_mm256_sub_pd(error, last_error), vdt);
+            __m256d command = _mm256_add_pd(
+                _mm256_add_pd(_mm256_mul_pd(_mm256_load_pd(&pid.kp[j]), error),
+                              _mm256_mul_pd(_mm256_load_pd(&pid.ki[j]), error_sum)),
+                _mm256_mul_pd(_mm256_load_pd(&pid.kd[j]), error_derivative));
+            
+            const __m256d abs_velocity = _mm256_andnot_pd(sign_mask, _mm256_load_pd(&velocity[j]));
+            const __m256d over_velocity = _mm256_cmp_pd(
+                abs_velocity, _mm256_load_pd(&pid.max_velocity[j]), _CMP_GT_OQ);
+            command = _mm256_andnot_pd(over_velocity, command);
+            
+            const __m256d hot = _mm256_cmp_pd(
+                _mm256_load_pd(&temperature[j]),
+                _mm256_mul_pd(_mm256_load_pd(&pid.max_temperature[j]), derate), _CMP_GT_OQ);
+            command = _mm256_blendv_pd(command, _mm256_mul_pd(command, half), hot);
+            
+            const __m256d limit = _mm256_load_pd(&pid.max_torque[j]);
+            command = _mm256_max_pd(command, _mm256_xor_pd(limit, sign_mask));
+            command = _mm256_min_pd(command, limit);
+            
+            _mm256_store_pd(&pid.error_sum[j], _mm256_blendv_pd(old_sum, error_sum, enabled));
+            _mm256_store_pd(&pid.last_error[j], _mm256_blendv_pd(last_error, error, enabled));
+            _mm256_store_pd(&torque[j], _mm256_blendv_pd(_mm256_load_pd(&torque[j]), command, enabled));
+            _mm256_store_pd(&torque_out[j], _mm256_blendv_pd(zero, command, enabled));
+        }
+    }
+#else
+    static void stepAvx2(PidBank& pid, JointStateBank& state, double dt, double* torque_out) {
+        stepScalar(pid, state, dt, torque_out, 0, pid.size());
+    }
+#endif
+
+private:
+    static bool cpuHasAvx2() {
+#ifdef HUMANOID_HAVE_AVX2_KERNELS
+        return __builtin_cpu_supports("avx2");
+#else
+        return false;
+#endif
+    }
+    
+    // Test mode: run the scalar reference and the vector path from the same
+    // starting state and count any bitwise difference
+    void stepVerify(PidBank& pid, JointStateBank& state, double dt, double* torque_out) {
+        const size_t n = pid.size();
+        const size_t bytes = n * sizeof(double);
+        std::memcpy(saved_error_sum_.data(), pid.error_sum.data(), bytes);
+        std::memcpy(saved_last_error_.data(), pid.last_error.data(), bytes);
+        std::memcpy(saved_torque_.data(), state.torque(), bytes);
+        
+        stepScalar(pid, state, dt, ref_out_.data(), 0, n);
+        std::memcpy(ref_error_sum_.data(), pid.error_sum.data(), bytes);
+        std::memcpy(ref_last_error_.data(), pid.last_error.data(), bytes);
+        std::memcpy(ref_torque_.data(), state.torque(), bytes);
+        
+        std::memcpy(pid.error_sum.data(), saved_error_sum_.data(), bytes);
+        std::memcpy(pid.last_error.data(), saved_last_error_.data(), bytes);
+        std::memcpy(state.torque(), saved_torque_.data(), bytes);
+        
+        if (use_avx2_) {
+            stepAvx2(pid, state, dt, torque_out);
+        } else {
+            stepScalar(pid, state, dt, torque_out, 0, n);
+        }
+        
+        if (std::memcmp(ref_out_.data(), torque_out, bytes) != 0 ||
+            std::memcmp(ref_error_sum_.data(), pid.error_sum.data(), bytes) != 0 ||
+            std::memcmp(ref_last_error_.data(), pid.last_error.data(), bytes) != 0 ||
+            std::memcmp(ref_torque_.data(), state.torque(), bytes) != 0) {
+            verify_mismatches_++;
+        }
+    }
+};
+
+// Per-joint safety limits, structure-of-arrays, indexed like JointStateBank
+struct SafetyLimits {
+    AlignedArray<double> min_position;
+    AlignedArray<double> max_position;
+    AlignedArray<double> max_velocity;
+    AlignedArray<double> max_temperature;
+    AlignedArray<double> max_torque;
+    AlignedArray<int64_t> max_age_ns;       // Oldest acceptable sample
+    
+    explicit SafetyLimits(size_t joints)
+        : min_position(joints), max_position(joints), max_velocity(joints),
+          max_temperature(joints), max_torque(joints), max_age_ns(joints) {}
+    
+    size_t size() const { return min_position.size(); }
+    size_t paddedSize() const { return min_position.capacity(); }
+};
+
+// Safety kernel: every limit for every joint in one pass, producing a
+// violation bitmask per joint instead of stopping at the first failure.
+// Comparisons are written as "not within limit", so NaN readings count as
+// violations. No I/O; reporting happens outside the real-time path.
+class SafetyKernel {
+public:
+    enum Violation : uint8_t {
+        OverTemperature = 1 << 0,
+        OverVelocity    = 1 << 1,
+        PositionLimit   = 1 << 2,
+        OverTorque      = 1 << 3,
+        StaleSample     = 1 << 4
+    };
+    
+    struct Result {
+        uint32_t violating_joints = 0;
+        uint8_t combined = 0;       // OR of all joint masks
+    };
+    
+    // violations must hold limits.size() entries
+    static Result check(const JointStateBank& state, const SafetyLimits& limits,
+                        int64_t now_ns, uint8_t* violations) {
+#ifdef HUMANOID_HAVE_AVX2_KERNELS
+        if (__builtin_cpu_supports("avx2")) {
+            return checkAvx2(state, limits, now_ns, violations);
+        }
+#endif
+        return checkScalar(state, limits, now_ns, violations, 0, limits.size());
+    }
+    
+    static uint8_t checkJoint(const JointStateBank& state, const SafetyLimits& limits,
+                              int64_t now_ns, size_t j) {
+        const double position = state.position()[j];
+        uint8_t mask = 0;
+        if (!(state.temperature()[j] < limits.max_temperature[j])) mask |= OverTemperature;
+        if (!(std::fabs(state.velocity()[j]) < limits.max_velocity[j])) mask |= OverVelocity;
+        if (!(position >= limits.min_position[j] && position <= limits.max_position[j])) mask |= PositionLimit;
+        if (!(std::fabs(state.torque()[j]) <= limits.max_torque[j])) mask |= OverTorque;
+        if (now_ns - state.timestampNs()[j] > limits.max_age_ns[j]) mask |= StaleSample;
+        return mask;
+    }
+    
+    static Result checkScalar(const JointStateBank& state, const SafetyLimits& limits,
+                              int64_t now_ns, uint8_t* violations, size_t begin, size_t end) {
+        Result result;
+        for (size_t j = begin; j < end; ++j) {
+            const uint8_t mask = checkJoint(state, limits, now_ns, j);
+            violations[j] = mask;
+            result.combined |= mask;
+            result.violating_joints += (mask != 0);
+        }
+        return result;
+    }
+
+#ifdef HUMANOID_HAVE_AVX2_KERNELS
+    __attribute__((target("avx2")))
+    static Result checkAvx2(const JointStateBank& state, const SafetyLimits& limits,
+                            int64_t now_ns, uint8_t* violations) {
+        const __m256d sign_mask = _mm256_set1_pd(-0.0);
+        const __m256i now = _mm256_set1_epi64x(now_ns);
+        const __m256i bit_temperature = _mm256_set1_epi64x(OverTemperature);
+        const __m256i bit_velocity = _mm256_set1_epi64x(OverVelocity);
+        const __m256i bit_position = _mm256_set1_epi64x(PositionLimit);
+        const __m256i bit_torque = _mm256_set1_epi64x(OverTorque);
+        const __m256i bit_stale = _mm256_set1_epi64x(StaleSample);
+        alignas(32) int64_t lane_masks[4];
+        
+        Result result;
+        const size_t n = limits.size();
+        for (size_t j = 0; j < n; j += 4) {
+            const __m256d position = _mm256_load_pd(&state.position()[j]);
+            const __m256i over_temperature = _mm256_castpd_si256(_mm256_cmp_pd(
+                _mm256_load_pd(&state.temperature()[j]),
+                _mm256_load_pd(&limits.max_temperature[j]), _CMP_NLT_UQ));
+            const __m256i over_velocity = _mm256_castpd_si256(_mm256_cmp_pd(
+                _mm256_andnot_pd(sign_mask, _mm256_load_pd(&state.velocity()[j])),
+                _mm256_load_pd(&limits.max_velocity[j]), _CMP_NLT_UQ));
+            const __m256i below = _mm256_castpd_si256(_mm256_cmp_pd(
+                position, _mm256_load_pd(&limits.min_position[j]), _CMP_NGE_UQ));
+            const __m256i above = _mm256_castpd_si256(_mm256_cmp_pd(
+                position, _mm256_load_pd(&limits.max_position[j]), _CMP_NLE_UQ));
+            const __m256i over_torque = _mm256_castpd_si256(_mm256_cmp_pd(
+                _mm256_andnot_pd(sign_mask, _mm256_load_pd(&state.torque()[j])),
+                _mm256_load_pd(&limits.max_torque[j]), _CMP_NLE_UQ));
+            const __m256i age = _mm256_sub_epi64(now, _mm256_load_si256(
+                reinterpret_cast<const __m256i*>(&state.timestampNs()[j])));
+            const __m256i stale = _mm256_cmpgt_epi64(age, _mm256_load_si256(
+                reinterpret_cast<const __m256i*>(&limits.max_age_ns[j])));
+            
+            __m256i mask = _mm256_and_si256(over_temperature, bit_temperature);
+            mask = _mm256_or_si256(mask, _mm256_and_si256(over_velocity, bit_velocity));
+            mask = _mm256_or_si256(mask, _mm256_and_si256(_mm256_or_si256(below, above), bit_position));
+            mask = _mm256_or_si256(mask, _mm256_and_si256(over_torque, bit_torque));
+            mask = _mm256_or_si256(mask, _mm256_and_si256(stale, bit_stale));
+            _mm256_store_si256(reinterpret_cast<__m256i*>(lane_masks), mask);
+            
+            // Padded lanes beyond the joint count are ignored
+            const size_t lanes = std::min<size_t>(4, n - j);
+            for (size_t k = 0; k < lanes; ++k) {
+                const uint8_t m = static_cast<uint8_t>(lane_masks[k]);
+                violations[j + k] = m;
+                result.combined |= m;
+                result.violating_joints += (m != 0);
+            }
+        }
+        return result;
+    }
+#endif
+};
+
+// Joint controller with safety monitoring. Gains and integrator state live
+// in the shared PidBank; this class is the per-joint handle.
+class JointController {
+private:
+    std::string name_;
+    Actuator actuator_;
+    
+    // Joint and PID state live in the shared banks, addressed by index
+    JointStateBank* state_bank_;
+    PidBank* pid_bank_;
+    size_t joint_index_;
+    
+    // Command bus slot (torques are staged, not written synchronously)
+    CommandBus* command_bus_;
+    size_t bus_slot_;
+    
+    // Joint limits
+    SafetyLimits* limits_;
+    double min_position_;
+    double max_position_;
+    
+public:
+    JointController(const std::string& name, JointStateBank& state_bank,
+                    PidBank& pid_bank, SafetyLimits& limits, size_t joint_index)
+        : name_(name), actuator_(name + "_actuator"), 
+          state_bank_(&state_bank), pid_bank_(&pid_bank), joint_index_(joint_index),
+          command_bus_(nullptr), bus_slot_(0),
+          limits_(&limits), min_position_(-M_PI), max_position_(M_PI) {
+        const size_t j = joint_index_;
+        limits.min_position[j] = min_position_;
+        limits.max_position[j] = max_position_;
+        limits.max_temperature[j] = 70.0;
+        limits.max_velocity[j] = 5.0;
+        limits.max_torque[j] = actuator_.getMaxTorque();
+        limits.max_age_ns[j] = 100000000;   // 100ms
+        
+        pid_bank.kp[j] = 100.0;
+        pid_bank.ki[j] = 10.0;
+        pid_bank.kd[j] = 5.0;
+        pid_bank.target[j] = 0.0;
+        pid_bank.error_sum[j] = 0.0;
+        pid_bank.last_error[j] = 0.0;
+        pid_bank.max_temperature[j] = 70.0;
+        pid_bank.max_velocity[j] = 5.0;
+        pid_bank.max_torque[j] = actuator_.getMaxTorque();
+        pid_bank.enabled[j] = 0;
+    }
+    
+    // Attach this joint's actuator to the shared command bus
+    void attachBus(CommandBus& bus) {
+        command_bus_ = &bus;
+        bus_slot_ = bus.attach(&actuator_);
+    }
+    
+    bool initialize() {
+        // Initialize sensors and actuator
+        if (!command_bus_) {
+            AsyncLogger::instance().log(LogEvent::ControllerNoBus, name_.c_str());
+            return false;
+        }
+        pid_bank_->enabled[joint_index_] = -1;
+        AsyncLogger::instance().log(LogEvent::ControllerInitialized, name_.c_str());
+        return true;
+    }
+    
+    // Single-joint update through the scalar reference path. The control
+    // loop uses PidKernel::step over all joints instead.
+    void update(double dt) {
+        if (!isEnabled()) return;
+        
+        double torque_command = 0.0;
+        const size_t j = joint_index_;
+        PidKernel::stepScalar(*pid_bank_, *state_bank_, dt, &torque_command, j, j + 1);
+        stageCommand(torque_command);
+    }
+    
+    // Stage a torque computed by the batched kernel for this cycle's bus frame
+    void stageCommand(double torque_command) {
+        if (isEnabled()) {
+            command_bus_->stage(bus_slot_, torque_command);
+        }
+    }
+    
+    void setTargetPosition(double position) {
+        pid_bank_->target[joint_index_] = std::clamp(position, min_position_, max_position_);
+    }
+    
+    JointState getState() const {
+        return state_bank_->load(joint_index_);
+    }
+    
+    const std::string& getName() const { return name_; }
+    size_t getJointIndex() const { return joint_index_; }
+    const Actuator& getActuator() const { return actuator_; }
+    bool isEnabled() const { return pid_bank_->enabled[joint_index_] != 0; }
+    
+    // Safety checks for this joint alone; SafetyMonitor checks all joints
+    // at once with SafetyKernel
+    uint8_t checkSafety(int64_t now_ns) const {
+        return SafetyKernel::checkJoint(*state_bank_, *limits_, now_ns, joint_index_);
+    }
+    
+    bool isSafe(int64_t now_ns) const {
+        return checkSafety(now_ns) == 0;
+    }
+};
+
+#endif  // HUMANOID_CONTROL_JOINT_CONTROL_HPP
@@ -0,0 +1,256 @@
+// Real-time safe asynchronous logging
+
+#ifndef HUMANOID_CONTROL_LOGGING_HPP
+#define HUMANOID_CONTROL_LOGGING_HPP
+
+#include "humanoid_control/core.hpp"
+#include "humanoid_control/state.hpp"
+
+// Log events. Each has a fixed format in kLogFormats; "{}" takes the next
+// argument, "{.N}" prints a double in fixed notation with N decimals.
+enum class LogEvent : uint16_t {
+    ControllerNoBus,
+    ControllerInitialized,
+    ControllerInitFailed,
+    HumanoidInitializing,
+    HumanoidInitialized,
+    HumanoidInitFailed,
+    LoopStarting,
+    ScheduleConfigured,
+    ScheduleUnschedulable,
+    StatusHeader,
+    StatusRule,
+    Status,
+    JointUnsafe,
+    JointSensorDisconnected,
+    ImuSensorDisconnected,
+    EmergencyStopRequested,
+    TelemetryOpened,
+    TelemetryOpenFailed,
+    TelemetryClosed,
+    RtSchedulerFailed,
+    RtAffinityFailed,
+    RtNoIsolatedCpu,
+    RtLockFailed,
+    RtConfigured,
+    RtWakeLatency,
+    RealtimeAllocation,
+    Count
+};
+
+constexpr const char* kLogFormats[] = {
+    "Joint controller '{}' has no command bus",
+    "Joint controller '{}' initialized",
+    "Failed to initialize controller: {}",
+    "Initializing Humanoid Robot Controller...",
+    "Humanoid controller initialized successfully!",
+    "Failed to initialize controller. Exiting.",
+    "Starting control loop at {}Hz",
+    "Multi-rate schedule: {} tasks on a {}us base tick, utilization {.2} of {.2}",
+    "Multi-rate schedule is not schedulable: utilization {.2} exceeds the bound {.2}",
+    "Time(s)\tLeft Hip Pos\tRight Hip Pos\tBalance Est\tSafety",
+    "--------------------------------------------------------------------",
+    "{.3}\t{.3}\t\t{.3}\t\t{.3}\t\t{}",
+    "SAFETY: Joint {} is not safe:{}{}{}{}{}",
+    "SAFETY: Joint sensor {} is disconnected!",
+    "SAFETY: IMU sensor {} is disconnected!",
+    "EMERGENCY STOP ACTIVATED!",
+    "Telemetry: {} records of {} bytes per segment, {} segments in {}",
+    "Telemetry: cannot open: {}",
+    "Telemetry: {} records written, {} segment rotations",
+    "RT setup: cannot set scheduler policy {} priority {}: {} (running at default priority)",
+    "RT setup: cannot pin to CPU {}: {}",
+    "RT setup: no isolated CPU {} found, thread is not pinned",
+    "RT setup: mlockall failed: {} (pages may fault in the loop)",
+    "RT setup: scheduler {}, affinity {} (cpu {}), mlockall {}, prefault stack {} heap {}",
+    "RT setup: wakeup latency p50 {.3}us, p99 {.3}us, max {.3}us",
+    "ALLOC GUARD: {}-byte allocation on a real-time thread"
+};
+static_assert(sizeof(kLogFormats) / sizeof(kLogFormats[0]) == size_t(LogEvent::Count),
+              "every LogEvent needs a format");
+
+// One log argument. A string is an offset into its record's text buffer,
+// so the caller's string may go away as soon as log() returns.
+struct LogArg {
+    enum Type : uint8_t { Int, Double, String };
+    Type type;
+    union {
+        int64_t i;
+        double d;
+        uint32_t text;
+    };
+};
+
+// Fixed-size binary log record: an event id plus its arguments, formatted
+// later by the logger thread. String arguments are copied into text and
+// truncated once it is full.
+struct LogRecord {
+    static constexpr size_t kMaxArgs = 6;
+    static constexpr size_t kTextBytes = 96;
+    LogEvent event;
+    uint8_t arg_count;
+    uint8_t text_used;
+    LogArg args[kMaxArgs];
+    char text[kTextBytes];
+};
+
+// Asynchronous logger. Producers copy a LogRecord into their own SPSC ring
+// and never block, allocate or make a syscall; a full ring drops the record
+// and counts it. A thread leases a ring on its first log call and hands it
+// back when it exits, so short-lived threads do not use up the rings. While
+// every ring is leased, further threads share one lock-free MPSC overflow
+// ring: a compare-and-swap on a shared index instead of a plain store, but
+// still no lock, so nothing is lost for want of a ring and no thread waits
+// on another. A background thread formats the records and writes them to
+// the output stream. Records from one thread stay in order; records from
+// different threads are interleaved in drain order. A logger must outlive
+// the threads that log to it, as the process-wide instance() does.
+class AsyncLogger {
+public:
+    static constexpr size_t kMaxThreads = 8;
+    static constexpr size_t kRingCapacity = 1024;
+
+private:
+    using Ring = SpscRing<LogRecord, kRingCapacity>;
+    using OverflowRing = MpscRing<LogRecord, kRingCapacity>;
+    
+    // A thread's claim on one ring, released by the thread's exit. Leasing
+    // registers a thread-exit destructor, a one-off libc allocation that
+    // the allocation guard does not see.
+    struct RingLease {
+        AsyncLogger* logger = nullptr;
+        int index = -1;
+        
+        ~RingLease() {
+            if (logger) {
+                logger->leased_[index].store(false, std::memory_order_release);
+            }
+        }
+    };
+    
+    std::array<Ring, kMaxThreads> rings_;
+    std::array<std::atomic<bool>, kMaxThreads> leased_;
+    OverflowRing overflow_;                     // Threads without a lease
+    std::atomic<uint64_t> flush_requests_;
+    std::atomic<uint64_t> flushes_done_;
+    std::atomic<bool> running_;
+    std::atomic<bool> enabled_;
+    std::ostream* out_;
+    std::mutex writer_mutex_;                   // Logger thread vs inline flush
+    std::thread writer_;
+
+public:
+    explicit AsyncLogger(std::ostream& out);
+    ~AsyncLogger();
+    
+    AsyncLogger(const AsyncLogger&) = delete;
+    AsyncLogger& operator=(const AsyncLogger&) = delete;
+    
+    // Process-wide logger writing to std::cout
+    static AsyncLogger& instance();
+    
+    // Real-time safe: a fixed-size copy into this thread's ring
+    template <typename... Args>
+    void log(LogEvent event, Args... args) {
+        static_assert(sizeof...(Args) <= LogRecord::kMaxArgs, "too many log arguments");
+        if (!enabled_.load(std::memory_order_relaxed) || threadMuteDepth() > 0) return;
+        LogRecord record;
+        record.event = event;
+        record.arg_count = 0;
+        record.text_used = 0;
+        (setArg(record, record.args[record.arg_count++], args), ...);
+        
+        if (Ring* ring = threadRing()) {
+            ring->tryPush(record);
+            return;
+        }
+        overflow_.tryPush(record);
+    }
+    
+    // Block until everything logged before this call has been written.
+    // Not for the real-time thread.
+    void flush();
+    
+    // Discard every thread's records instead of queueing them
+    void setEnabled(bool enabled) { enabled_.store(enabled, std::memory_order_relaxed); }
+    
+    // Discard the calling thread's records while in scope, e.g. on a worker
+    // running a batch of simulations; other threads keep logging. Nests.
+    class ThreadMute {
+    public:
+        ThreadMute() { ++threadMuteDepth(); }
+        ~ThreadMute() { --threadMuteDepth(); }
+        
+        ThreadMute(const ThreadMute&) = delete;
+        ThreadMute& operator=(const ThreadMute&) = delete;
+    };
+    
+    uint64_t dropped() const {
+        uint64_t total = overflow_.dropped();
+        for (const auto& ring : rings_) {
+            total += ring.dropped();
+        }
+        return total;
+    }
+
+private:
+    // Shared by every logger; a plain int needs no TLS initialisation
+    static int& threadMuteDepth() {
+        static thread_local int depth = 0;
+        return depth;
+    }
+    
+    // This thread's ring, leasing a free one on first use; nullptr when
+    // every ring is leased or the thread already holds another logger's
+    Ring* threadRing() {
+        static thread_local RingLease lease;
+        if (lease.logger == this) {
+            return &rings_[lease.index];
+        }
+        if (lease.logger) {
+            return nullptr;
+        }
+        for (size_t i = 0; i < kMaxThreads; ++i) {
+            bool expected = false;
+            if (leased_[i].compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+                lease.logger = this;
+                lease.index = static_cast<int>(i);
+                return &rings_[i];
+            }
+        }
+        return nullptr;
+    }
+    
+    template <typename T>
+    static void setArg(LogRecord& record, LogArg& arg, T value) {
+        if constexpr (std::is_convertible<T, const char*>::value) {
+            arg.type = LogArg::String;
+            arg.text = record.text_used;
+            const char* s = value ? static_cast<const char*>(value) : "(null)";
+            size_t used = record.text_used;
+            while (*s && used + 1 < LogRecord::kTextBytes) {
+                record.text[used++] = *s++;
+            }
+            if (used < LogRecord::kTextBytes) {
+                record.text[used++] = '\0';
+            }
+            record.text_used = static_cast<uint8_t>(used);
+        } else if constexpr (std::is_floating_point<T>::value) {
+            arg.type = LogArg::Double;
+            arg.d = value;
+        } else {
+            static_assert(std::is_integral<T>::value || std::is_enum<T>::value,
+                          "log arguments are integers, floating point or C strings");
+            arg.type = LogArg::Int;
+            arg.i = static_cast<int64_t>(value);
+        }
+    }
+    
+    void writerLoop();
+    size_t drainAll();
+    void format(const LogRecord& record);
+    static void writeArg(std::ostream& out, const LogRecord& record, const LogArg& arg,
+                         int precision);
+};
+
+#endif  // HUMANOID_CONTROL_LOGGING_HPP
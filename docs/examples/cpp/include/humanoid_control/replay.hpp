@@ -0,0 +1,32 @@
+// Deterministic replay of recorded telemetry
+
+#ifndef HUMANOID_CONTROL_REPLAY_HPP
+#define HUMANOID_CONTROL_REPLAY_HPP
+
+#include "humanoid_control/core.hpp"
+#include "humanoid_control/telemetry.hpp"
+#include "humanoid_control/humanoid_controller.hpp"
+
+// Deterministic replay: runs a recorded log through a fresh controller as
+// fast as the pipeline allows and compares its torque commands and balance
+// estimate with what was recorded. The same log and build always produce
+// the same output_hash, so a controller change that alters behaviour shows
+// up as a different hash and a non-zero command error.
+class ReplayEngine {
+public:
+    struct Result {
+        bool ok = false;
+        uint64_t cycles = 0;
+        int64_t stopped_at_cycle = -1;      // First cycle that did not run
+        double max_command_error = 0.0;     // Against the recorded torques
+        double max_balance_error = 0.0;
+        uint64_t output_hash = 0;           // FNV-1a over commands and balance
+        double recorded_seconds = 0.0;
+        double wall_seconds = 0.0;
+        std::string error;
+    };
+    
+    static Result run(HumanoidController& controller, TelemetryReader& log);
+};
+
+#endif  // HUMANOID_CONTROL_REPLAY_HPP
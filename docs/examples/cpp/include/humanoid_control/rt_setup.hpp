@@ -0,0 +1,67 @@
+// Real-time thread configuration
+
+#ifndef HUMANOID_CONTROL_RT_SETUP_HPP
+#define HUMANOID_CONTROL_RT_SETUP_HPP
+
+#include "humanoid_control/core.hpp"
+#include "humanoid_control/executor.hpp"
+#include "humanoid_control/logging.hpp"
+
+// Real-time setup for the control thread: scheduling policy and priority,
+// CPU pinning, memory locking and stack/heap prefaulting. Every step is
+// best effort, so the same binary runs unprivileged (e.g. in CI); failures
+// are logged and recorded in the report instead of aborting. Output goes
+// through the AsyncLogger, so apply() is safe on any thread, including the
+// safety watchdog's.
+struct RtConfig {
+    bool enabled = true;
+    int policy = SCHED_FIFO;
+    int priority = 80;
+    int cpu = -1;                          // -1: an isolated CPU, if any
+    int isolated_index = 0;                // With cpu == -1: which isolated CPU
+    bool lock_memory = true;
+    size_t heap_prefault_bytes = 8 << 20;  // Pre-touched and kept by malloc
+    int latency_probe_samples = 200;
+    int64_t latency_probe_period_ns = 500000;
+};
+
+struct RtReport {
+    bool scheduler_set = false;
+    bool affinity_set = false;
+    bool memory_locked = false;
+    bool stack_prefaulted = false;
+    bool heap_prefaulted = false;
+    int cpu = -1;
+    int64_t wake_p50_ns = 0;
+    int64_t wake_p99_ns = 0;
+    int64_t wake_max_ns = 0;
+};
+
+class RtSetup {
+public:
+    static constexpr size_t kStackPrefaultBytes = 256 * 1024;
+
+    // Configure the calling thread before its loop starts
+    static RtReport apply(const RtConfig& config);
+    static void log(const RtReport& report);
+
+private:
+    // Touch the stack pages the loop may use so they are resident (and
+    // locked, after mlockall) before the first cycle
+    static bool prefaultStack();
+    
+#ifdef __linux__
+    // Grow the heap once, touching every page, and stop malloc from handing
+    // memory back so later allocations reuse resident pages
+    static bool prefaultHeap(size_t bytes);
+    
+    // index-th CPU of the isolated list ("2-3,6" style), or -1
+    static int isolatedCpu(int index);
+#endif
+    
+    // Measure the tail latency achieved with this configuration using the
+    // same absolute-deadline sleep as the control loop
+    static void probeWakeLatency(const RtConfig& config, RtReport& report);
+};
+
+#endif  // HUMANOID_CONTROL_RT_SETUP_HPP
@@ -0,0 +1,125 @@
+// Per-cycle safety monitoring
+
+#ifndef HUMANOID_CONTROL_SAFETY_MONITOR_HPP
+#define HUMANOID_CONTROL_SAFETY_MONITOR_HPP
+
+#include "humanoid_control/core.hpp"
+#include "humanoid_control/state.hpp"
+#include "humanoid_control/logging.hpp"
+#include "humanoid_control/sensors.hpp"
+#include "humanoid_control/actuation.hpp"
+#include "humanoid_control/joint_control.hpp"
+#include "humanoid_control/allocation.hpp"
+
+// Safety monitoring system. checkSafety runs the vectorized kernel over all
+// joints and logs what it found through AsyncLogger, so the control thread
+// never formats text. The combined violation mask is also published for
+// SafetyWatchdog. Per-joint masks live only for one check, in the caller's
+// cycle arena or the monitor's own.
+class SafetyMonitor {
+private:
+    const JointStateBank* state_bank_;
+    const SafetyLimits* limits_;
+    std::vector<JointController*> controllers_;
+    std::vector<JointSensor*> joint_sensors_;
+    std::vector<ImuSensor*> imu_sensors_;
+    
+    CycleArena own_scratch_;                // For callers without a cycle arena
+    
+    std::atomic<uint8_t> violation_mask_;   // OR of the last check
+    EmergencyStop* estop_;
+
+public:
+    SafetyMonitor(const JointStateBank& state_bank, const SafetyLimits& limits,
+                  EmergencyStop& estop)
+        : state_bank_(&state_bank), limits_(&limits),
+          own_scratch_(limits.size()), violation_mask_(0), estop_(&estop) {}
+    
+    // Controllers are kept for their names when logging
+    void addController(JointController* controller) {
+        controllers_.push_back(controller);
+    }
+    
+    void addJointSensor(JointSensor* sensor) {
+        joint_sensors_.push_back(sensor);
+    }
+    
+    void addImuSensor(ImuSensor* sensor) {
+        imu_sensors_.push_back(sensor);
+    }
+    
+    bool checkSafety(int64_t now_ns) {
+        own_scratch_.reset();
+        return checkSafety(now_ns, own_scratch_);
+    }
+    
+    // scratch holds the per-joint masks until the check returns
+    bool checkSafety(int64_t now_ns, std::pmr::memory_resource& scratch) {
+        // Check if emergency stop is active
+        if (isEmergencyStopActive()) {
+            return false;
+        }
+        
+        // Check all joint limits in one pass
+        std::pmr::vector<uint8_t> violations(limits_->size(), 0, &scratch);
+        const SafetyKernel::Result result =
+            SafetyKernel::check(*state_bank_, *limits_, now_ns, violations.data());
+        violation_mask_.store(result.combined, std::memory_order_release);
+        
+        if (result.violating_joints > 0) {
+            // Latch first, then log what happened
+            estop_->trigger(EmergencyStop::LimitViolation, now_ns);
+            logViolations(violations);
+            return false;
+        }
+        
+        // Check sensors; a disconnected sensor fails this cycle only
+        for (auto* sensor : joint_sensors_) {
+            if (!sensor->isConnected()) {
+                AsyncLogger::instance().log(LogEvent::JointSensorDisconnected,
+                                            sensor->getName().c_str());
+                return false;
+            }
+        }
+        
+        for (auto* sensor : imu_sensors_) {
+            if (!sensor->isConnected()) {
+                AsyncLogger::instance().log(LogEvent::ImuSensorDisconnected,
+                                            sensor->getName().c_str());
+                return false;
+            }
+        }
+        
+        return true;
+    }
+    
+    // Combined mask from the most recent check (any thread)
+    uint8_t violationMask() const { return violation_mask_.load(std::memory_order_acquire); }
+    
+    bool isEmergencyStopActive() const {
+        return estop_->isActive();
+    }
+    
+    void triggerEmergencyStop() {
+        estop_->trigger(EmergencyStop::Requested, CycleClock::steadyNowNs());
+        AsyncLogger::instance().log(LogEvent::EmergencyStopRequested);
+    }
+
+private:
+    // One record per violating joint, one string argument per violation bit
+    void logViolations(const std::pmr::vector<uint8_t>& violations) const {
+        for (size_t j = 0; j < violations.size() && j < controllers_.size(); ++j) {
+            const uint8_t mask = violations[j];
+            if (mask == 0) continue;
+            AsyncLogger::instance().log(LogEvent::JointUnsafe,
+                controllers_[j]->getName().c_str(),
+                (mask & SafetyKernel::OverTemperature) ? " over-temperature" : "",
+                (mask & SafetyKernel::OverVelocity) ? " over-velocity" : "",
+                (mask & SafetyKernel::PositionLimit) ? " position-limit" : "",
+                (mask & SafetyKernel::OverTorque) ? " over-torque" : "",
+                (mask & SafetyKernel::StaleSample) ? " stale-sample" : "");
+        }
+    }
+};
+
+#endif  // HUMANOID_CONTROL_SAFETY_MONITOR_HPP
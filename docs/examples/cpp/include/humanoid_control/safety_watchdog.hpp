@@ -0,0 +1,114 @@
+// Independent safety watchdog thread
+
+#ifndef HUMANOID_CONTROL_SAFETY_WATCHDOG_HPP
+#define HUMANOID_CONTROL_SAFETY_WATCHDOG_HPP
+
+#include "humanoid_control/core.hpp"
+#include "humanoid_control/actuation.hpp"
+#include "humanoid_control/safety_monitor.hpp"
+#include "humanoid_control/executor.hpp"
+#include "humanoid_control/rt_setup.hpp"
+
+// Safety watchdog: its own thread, ideally on its own isolated core, ticking
+// faster than the control loop. It trips the e-stop when the control loop's
+// heartbeat stops advancing or the published violation mask is non-zero,
+// and wakes the command bus so the actuators are zeroed even when no more
+// frames arrive. Reaction time is bounded by timeout + one watchdog period,
+// whatever state the control loop is in.
+class SafetyWatchdog {
+public:
+    struct Options {
+        int64_t period_ns = 1000000;                // 1kHz
+        int64_t heartbeat_timeout_ns = 20000000;    // 20ms without a beat
+        RtConfig rt;
+        
+        Options() {
+            rt.priority = 90;           // Above the control loop
+            rt.isolated_index = 1;      // The control loop takes the first
+            rt.lock_memory = false;     // Process-wide, done by the control thread
+            rt.heap_prefault_bytes = 0;
+            rt.latency_probe_samples = 0;
+        }
+        
+        // At least as fast as the fastest safety check and four times the
+        // control rate, tripping after four missed control cycles
+        static Options forRates(double control_frequency, double safety_frequency) {
+            Options options;
+            const int64_t control_period_ns = static_cast<int64_t>(1e9 / control_frequency);
+            const int64_t safety_period_ns = static_cast<int64_t>(1e9 / safety_frequency);
+            options.period_ns = std::max<int64_t>(std::min(control_period_ns / 4, safety_period_ns),
+                                                  100000);
+            options.heartbeat_timeout_ns = 4 * control_period_ns;
+            return options;
+        }
+    };
+
+private:
+    EmergencyStop* estop_;
+    const SafetyMonitor* monitor_;
+    CommandBus* command_bus_;
+    Options options_;
+    
+    std::atomic<uint64_t> heartbeat_;
+    std::atomic<bool> armed_;
+    std::atomic<int64_t> max_gap_ns_;       // Longest time between beats seen
+    std::atomic<int64_t> reaction_ns_;      // Trip to bus halt, -1 if none
+    PeriodicExecutor executor_;
+    std::thread thread_;
+    RtReport rt_report_;
+
+public:
+    SafetyWatchdog(EmergencyStop& estop, const SafetyMonitor& monitor,
+                   CommandBus& command_bus, const Options& options)
+        : estop_(&estop), monitor_(&monitor), command_bus_(&command_bus),
+          options_(options), heartbeat_(0), armed_(false), max_gap_ns_(0),
+          reaction_ns_(-1), executor_(options.period_ns) {}
+    
+    ~SafetyWatchdog() { stop(); }
+    
+    SafetyWatchdog(const SafetyWatchdog&) = delete;
+    SafetyWatchdog& operator=(const SafetyWatchdog&) = delete;
+    
+    // Call before start(), e.g. once the loop's rates are known
+    void setOptions(const Options& options) {
+        options_ = options;
+        executor_.setPeriod(options.period_ns);
+    }
+    
+    const Options& options() const { return options_; }
+    
+    // Called by the control loop once per cycle; wait-free
+    void beat() {
+        heartbeat_.fetch_add(1, std::memory_order_release);
+    }
+    
+    // Start watching; the heartbeat timeout counts from here
+    void start() {
+        if (thread_.joinable()) return;
+        armed_ = true;
+        executor_.rearm();
+        thread_ = std::thread([this] { watchLoop(); });
+    }
+    
+    // Orderly shutdown: disarm first so a control loop that is stopping on
+    // purpose is not mistaken for a hung one
+    void disarm() { armed_ = false; }
+    
+    void stop() {
+        disarm();
+        executor_.stop();
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+    }
+    
+    uint64_t ticks() const { return executor_.cycles(); }
+    int64_t maxHeartbeatGapNs() const { return max_gap_ns_.load(std::memory_order_relaxed); }
+    int64_t reactionNs() const { return reaction_ns_.load(std::memory_order_relaxed); }
+    const RtReport& rtReport() const { return rt_report_; }
+
+private:
+    void watchLoop();
+};
+
+#endif  // HUMANOID_CONTROL_SAFETY_WATCHDOG_HPP
@@ -0,0 +1,171 @@
+// Rate-monotonic scheduler for multi-rate stages on one thread
+
+#ifndef HUMANOID_CONTROL_SCHEDULER_HPP
+#define HUMANOID_CONTROL_SCHEDULER_HPP
+
+#include "humanoid_control/core.hpp"
+#include "humanoid_control/executor.hpp"
+#include "humanoid_control/instrumentation.hpp"
+
+// Rate-monotonic scheduler for stages that run at different rates inside
+// one periodic timer. Each task registers a period, a phase (its first
+// release), a CPU budget and the pipeline stage it belongs to. The
+// executor ticks at the base period, the greatest common divisor of every
+// period and phase; rates whose divisor falls below kMinBaseTickNs are
+// rejected rather than run on a near-continuous tick. Each tick runs the
+// tasks released at that instant in pipeline order, so safety checks the
+// samples read in the same tick, and shortest period first within a stage
+// (registration order among equal periods). Phases move slow tasks onto
+// ticks where little else runs. Every run is timed against its budget and,
+// with setInstrumentation(), summed into its stage's histogram per tick.
+//
+// Releases are derived from the tick's release time, not a tick count, so
+// skipped or degraded executor periods drop task releases instead of
+// shifting the schedule. Tasks are added at start-up; tick() never
+// allocates.
+class RateMonotonicScheduler {
+public:
+    // A task sees the same TickInfo it would get from its own executor:
+    // cycle counts its runs, period_ns is the time since its previous
+    // release and missed counts its releases dropped right before this one
+    using TaskFn = std::function<void(const PeriodicExecutor::TickInfo&)>;
+    using Stage = CycleInstrumentation::Stage;
+    
+    // Shortest base tick accepted; the executor's own wakeup cost would
+    // dominate anything faster
+    static constexpr int64_t kMinBaseTickNs = 50000;
+    
+    struct TaskSpec {
+        const char* name;
+        int64_t period_ns;
+        int64_t phase_ns = 0;       // First release, in [0, period)
+        int64_t budget_ns = 0;      // 0: not checked
+        Stage stage = CycleInstrumentation::kStageCount;  // Default: after every stage, untimed
+    };
+
+private:
+    struct Task {
+        TaskSpec spec;
+        TaskFn fn;
+        uint64_t next_release = 0;  // In base ticks from the first tick
+        int64_t last_release = -1;  // -1: not run since reset()
+        uint64_t runs = 0;
+        uint64_t missed_releases = 0;
+        uint64_t budget_overruns = 0;
+        LatencyHistogram execution_ns;
+        
+        Task(const TaskSpec& task_spec, TaskFn task_fn) : spec(task_spec), fn(std::move(task_fn)) {}
+    };
+    
+    std::deque<Task> tasks_;        // Stable addresses; histograms are not movable
+    std::vector<Task*> order_;      // Pipeline stage, then shortest period
+    int64_t base_ns_;
+    int64_t origin_ns_;             // Release time of the first tick
+    bool started_;
+    CycleInstrumentation* instrumentation_;
+
+public:
+    RateMonotonicScheduler()
+        : base_ns_(0), origin_ns_(0), started_(false), instrumentation_(nullptr) {}
+    
+    RateMonotonicScheduler(const RateMonotonicScheduler&) = delete;
+    RateMonotonicScheduler& operator=(const RateMonotonicScheduler&) = delete;
+    
+    // Start-up only; throws std::invalid_argument on a bad period, phase or
+    // budget, or when the task would bring the base tick below
+    // kMinBaseTickNs (e.g. 300 Hz next to 333 Hz)
+    size_t addTask(const TaskSpec& spec, TaskFn fn);
+    
+    // Per-stage time for each tick goes to these histograms; nullptr: off
+    void setInstrumentation(CycleInstrumentation* instrumentation) {
+        instrumentation_ = instrumentation;
+    }
+    
+    // Drop every task, e.g. to register a new rate set
+    void clear();
+    
+    // Restart the schedule: the next tick is tick zero again
+    void reset() {
+        started_ = false;
+        for (Task* task : order_) {
+            task->next_release = static_cast<uint64_t>(task->spec.phase_ns / base_ns_);
+            task->last_release = -1;
+        }
+    }
+    
+    // Executor period that serves every task; 0 without tasks
+    int64_t basePeriodNs() const { return base_ns_; }
+    
+    // Run every task released at this tick
+    void tick(const PeriodicExecutor::TickInfo& tick) {
+        if (!started_) {
+            origin_ns_ = tick.release_ns;
+            started_ = true;
+        }
+        const uint64_t now = static_cast<uint64_t>((tick.release_ns - origin_ns_) / base_ns_);
+        std::array<int64_t, CycleInstrumentation::kStageCount> stage_ns{};
+        std::array<bool, CycleInstrumentation::kStageCount> stage_ran{};
+        
+        for (Task* task : order_) {
+            if (now < task->next_release) continue;
+            
+            const uint64_t period = static_cast<uint64_t>(task->spec.period_ns / base_ns_);
+            const uint64_t missed = (now - task->next_release) / period;
+            const uint64_t release = task->next_release + missed * period;
+            const int64_t elapsed = task->last_release < 0
+                ? task->spec.period_ns
+                : (static_cast<int64_t>(release) - task->last_release) * base_ns_;
+            task->next_release = release + period;
+            task->last_release = static_cast<int64_t>(release);
+            task->missed_releases += missed;
+            
+            const PeriodicExecutor::TickInfo info{task->runs++,
+                                                  origin_ns_ + static_cast<int64_t>(release) * base_ns_,
+                                                  tick.wake_ns, elapsed, missed};
+            const int64_t start = PeriodicExecutor::monotonicNowNs();
+            task->fn(info);
+            const int64_t duration = PeriodicExecutor::monotonicNowNs() - start;
+            task->execution_ns.record(duration);
+            if (task->spec.budget_ns > 0 && duration > task->spec.budget_ns) {
+                task->budget_overruns++;
+            }
+            if (task->spec.stage < CycleInstrumentation::kStageCount) {
+                stage_ns[task->spec.stage] += duration;
+                stage_ran[task->spec.stage] = true;
+            }
+        }
+        
+        if (instrumentation_) {
+            for (int stage = 0; stage < CycleInstrumentation::kStageCount; ++stage) {
+                if (stage_ran[stage]) {
+                    instrumentation_->record(static_cast<Stage>(stage), stage_ns[stage]);
+                }
+            }
+        }
+    }
+    
+    size_t taskCount() const { return tasks_.size(); }
+    const TaskSpec& task(size_t index) const { return tasks_[index].spec; }
+    uint64_t runs(size_t index) const { return tasks_[index].runs; }
+    uint64_t missedReleases(size_t index) const { return tasks_[index].missed_releases; }
+    uint64_t budgetOverruns(size_t index) const { return tasks_[index].budget_overruns; }
+    const LatencyHistogram& executionTime(size_t index) const { return tasks_[index].execution_ns; }
+    
+    // Every period divides the next longer one
+    bool isHarmonic() const;
+    
+    // Sum of budget / period over the budgeted tasks
+    double utilization() const;
+    
+    // Rate-monotonic schedulability bound: 1.0 for harmonic periods,
+    // otherwise the Liu and Layland bound n(2^(1/n) - 1)
+    double utilizationBound() const;
+    
+    bool isSchedulable() const { return utilization() <= utilizationBound(); }
+    
+    // Per-task runs, execution time and budget overruns; not for the
+    // real-time thread
+    void printSummary(std::ostream& out) const;
+};
+
+#endif  // HUMANOID_CONTROL_SCHEDULER_HPP
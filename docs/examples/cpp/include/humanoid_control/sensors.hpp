@@ -0,0 +1,517 @@
+// Simulated joint and IMU sensors with reproducible noise
+
+#ifndef HUMANOID_CONTROL_SENSORS_HPP
+#define HUMANOID_CONTROL_SENSORS_HPP
+
+#include "humanoid_control/core.hpp"
+#include "humanoid_control/state.hpp"
+
+// Reproducible noise for simulated sensors. Every sensor owns an
+// independent xoshiro256++ stream whose seed is derived from a run seed and
+// the sensor name, so noise no longer depends on global call order and
+// sensors can be read from different threads.
+namespace Noise {
+    constexpr uint64_t kDefaultSeed = 0x5eed5eed5eed5eedULL;
+    constexpr double kTwoPi = 6.283185307179586476925;
+    
+    inline uint64_t splitmix64(uint64_t& x) {
+        uint64_t z = (x += 0x9e3779b97f4a7c15ULL);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+    
+    // FNV-1a: stable across platforms and runs, unlike std::hash
+    inline uint64_t hashName(const std::string& name) {
+        uint64_t h = 0xcbf29ce484222325ULL;
+        for (unsigned char c : name) {
+            h = (h ^ c) * 0x100000001b3ULL;
+        }
+        return h;
+    }
+    
+    inline uint64_t streamSeed(uint64_t seed, const std::string& name, uint64_t channel = 0) {
+        return seed ^ hashName(name) ^ (channel * 0xd1b54a32d192ed03ULL);
+    }
+    
+    inline uint64_t rotl(uint64_t x, int k) {
+        return (x << k) | (x >> (64 - k));
+    }
+    
+    // Uniform in (0, 1], safe for log()
+    inline double toUnit(uint64_t x) {
+        return static_cast<double>((x >> 11) + 1) * 0x1.0p-53;
+    }
+    
+    // Box-Muller, cosine branch only, so one normal always costs exactly
+    // two uniforms and batched and scalar streams stay aligned
+    inline double boxMuller(double u1, double u2) {
+        return std::sqrt(-2.0 * std::log(u1)) * std::cos(kTwoPi * u2);
+    }
+}
+
+// xoshiro256++ generator
+class Xoshiro256pp {
+private:
+    uint64_t s_[4];
+
+public:
+    explicit Xoshiro256pp(uint64_t seed = Noise::kDefaultSeed) { reseed(seed); }
+    
+    void reseed(uint64_t seed) {
+        for (auto& word : s_) {
+            word = Noise::splitmix64(seed);
+        }
+    }
+    
+    uint64_t next() {
+        const uint64_t result = Noise::rotl(s_[0] + s_[3], 23) + s_[0];
+        const uint64_t t = s_[1] << 17;
+        s_[2] ^= s_[0];
+        s_[3] ^= s_[1];
+        s_[1] ^= s_[2];
+        s_[0] ^= s_[3];
+        s_[2] ^= t;
+        s_[3] = Noise::rotl(s_[3], 45);
+        return result;
+    }
+    
+    double uniform() { return Noise::toUnit(next()); }
+    
+    double gaussian() {
+        const double u1 = uniform();
+        return Noise::boxMuller(u1, uniform());
+    }
+};
+
+// Sensor noise model: white Gaussian noise plus an optional first-order
+// Gauss-Markov (colored) component per channel
+struct NoiseModel {
+    double white_sigma = 0.0;
+    double colored_sigma = 0.0;
+    double correlation = 0.0;       // AR(1) coefficient per sample, [0, 1)
+};
+
+class NoiseGenerator {
+public:
+    static constexpr int kMaxChannels = 4;
+
+private:
+    Xoshiro256pp rng_;
+    NoiseModel model_;
+    double colored_gain_;
+    std::array<double, kMaxChannels> colored_state_;
+
+public:
+    explicit NoiseGenerator(const NoiseModel& model = NoiseModel(),
+                            uint64_t seed = Noise::kDefaultSeed)
+        : rng_(seed), colored_state_{} {
+        setModel(model);
+    }
+    
+    void setModel(const NoiseModel& model) {
+        model_ = model;
+        colored_gain_ = model.colored_sigma * std::sqrt(1.0 - model.correlation * model.correlation);
+    }
+    
+    void reseed(uint64_t seed) {
+        rng_.reseed(seed);
+        colored_state_.fill(0.0);
+    }
+    
+    const NoiseModel& model() const { return model_; }
+    
+    double next(int channel = 0) {
+        double noise = 0.0;
+        if (model_.white_sigma > 0.0) {
+            noise += model_.white_sigma * rng_.gaussian();
+        }
+        if (model_.colored_sigma > 0.0) {
+            double& state = colored_state_[channel];
+            state = model_.correlation * state + colored_gain_ * rng_.gaussian();
+            noise += state;
+        }
+        return noise;
+    }
+};
+
+// Batched white-noise source for a whole sensor array. Generator state is
+// stored structure-of-arrays (one lane per sensor channel), so the
+// xoshiro step and the uniform conversion vectorize across lanes; the
+// Box-Muller transform follows in a second pass.
+class NoiseBank {
+private:
+    AlignedArray<uint64_t> s0_, s1_, s2_, s3_;
+    AlignedArray<double> sigma_;
+    AlignedArray<double> u1_, u2_;
+
+public:
+    explicit NoiseBank(size_t lanes = 0)
+        : s0_(lanes), s1_(lanes), s2_(lanes), s3_(lanes), sigma_(lanes),
+          u1_(lanes), u2_(lanes) {}
+    
+    size_t size() const { return sigma_.size(); }
+    
+    void seedLane(size_t lane, uint64_t seed, double sigma) {
+        s0_[lane] = Noise::splitmix64(seed);
+        s1_[lane] = Noise::splitmix64(seed);
+        s2_[lane] = Noise::splitmix64(seed);
+        s3_[lane] = Noise::splitmix64(seed);
+        sigma_[lane] = sigma;
+    }
+    
+    // out[lane] = sigma[lane] * N(0, 1) for every lane in one call
+    void fill(double* out) {
+        const size_t n = size();
+        uniforms(u1_.data(), n);
+        uniforms(u2_.data(), n);
+        for (size_t i = 0; i < n; ++i) {
+            out[i] = sigma_[i] == 0.0 ? 0.0 : sigma_[i] * Noise::boxMuller(u1_[i], u2_[i]);
+        }
+    }
+
+private:
+    // One xoshiro256++ step per lane; no cross-lane dependency
+    void uniforms(double* out, size_t n) {
+        uint64_t* __restrict s0 = s0_.data();
+        uint64_t* __restrict s1 = s1_.data();
+        uint64_t* __restrict s2 = s2_.data();
+        uint64_t* __restrict s3 = s3_.data();
+        for (size_t i = 0; i < n; ++i) {
+            const uint64_t result = Noise::rotl(s0[i] + s3[i], 23) + s0[i];
+            const uint64_t t = s1[i] << 17;
+            s2[i] ^= s0[i];
+            s3[i] ^= s1[i];
+            s1[i] ^= s2[i];
+            s0[i] ^= s3[i];
+            s2[i] ^= t;
+            s3[i] = Noise::rotl(s3[i], 45);
+            out[i] = Noise::toUnit(result);
+        }
+    }
+};
+
+// Base class for sensors
+class Sensor {
+protected:
+    std::string name_;
+    double noise_level_;
+    bool is_connected_;
+    NoiseGenerator noise_;
+
+public:
+    Sensor(const std::string& name, double noise_level = 0.0) 
+        : name_(name), noise_level_(noise_level), is_connected_(true),
+          noise_(NoiseModel{noise_level, 0.0, 0.0},
+                 Noise::streamSeed(Noise::kDefaultSeed, name)) {}
+    
+    virtual ~Sensor() = default;
+    
+    // Take one reading at the given cycle time (steady_clock nanoseconds)
+    virtual void read(int64_t now_ns) = 0;
+    virtual bool isConnected() const { return is_connected_; }
+    const std::string& getName() const { return name_; }
+    double getNoiseLevel() const { return noise_level_; }
+    
+    // Reproducible per-sensor stream: same seed and name, same noise
+    void setNoiseSeed(uint64_t seed) {
+        noise_.reseed(Noise::streamSeed(seed, name_));
+    }
+    
+    void setNoiseModel(const NoiseModel& model) {
+        noise_level_ = model.white_sigma;
+        noise_.setModel(model);
+    }
+    
+    // Add noise to a value (simulation)
+    double addNoise(double value, int channel = 0) {
+        return value + noise_.next(channel);
+    }
+};
+
+// Joint sensor class
+class JointSensor : public Sensor {
+private:
+    JointState state_;                  // Writer-side working copy
+    SeqLock<JointState> published_;     // Lock-free snapshot for readers
+    int64_t read_ns_;                   // Time of the last encoder read
+    int64_t temperature_ns_;            // Time of the last temperature read
+
+public:
+    JointSensor(const std::string& name, double noise_level = 0.01) 
+        : Sensor(name, noise_level), published_(state_), read_ns_(-1), temperature_ns_(-1) {}
+    
+    static constexpr int kNoiseChannels = 3;    // position, velocity, torque
+    static constexpr int kTemperatureChannel = 3;
+    
+    // Winding heating per newton-metre of torque, degrees per second
+    static constexpr double kHeatingRate = 0.02;
+    static constexpr int64_t kTemperaturePeriodNs = 100000000;  // Polled at 10Hz
+    
+    // Read interval the simulated drift is expressed in. Drift scales with
+    // the time since the previous read and noise with its square root, so
+    // the encoder rate does not change how fast the simulated joint wanders.
+    static constexpr int64_t kDriftIntervalNs = 5000000;
+    
+    // read(), readTemperature() and setState() are the single writer and
+    // must run on one thread
+    void read(int64_t now_ns) override {
+        double noise[kNoiseChannels];
+        for (int ch = 0; ch < kNoiseChannels; ++ch) {
+            noise[ch] = noise_.next(ch);
+        }
+        read(now_ns, noise);
+    }
+    
+    // Read with externally generated noise (e.g. from a NoiseBank)
+    void read(int64_t now_ns, const double noise[kNoiseChannels]) {
+        const double t = now_ns * 1e-9;
+        const double scale = read_ns_ < 0 ? 1.0 : double(now_ns - read_ns_) / kDriftIntervalNs;
+        const double noise_scale = std::sqrt(scale);
+        read_ns_ = now_ns;
+        
+        // In a real system, this would interface with hardware
+        // For simulation, we'll generate realistic values
+        state_.position = state_.position + 0.01 * sin(t) * scale + noise[0] * noise_scale;
+        state_.velocity = state_.velocity + 0.001 * cos(t) * scale + noise[1] * noise_scale;
+        state_.torque = state_.torque + 0.05 * sin(t * 2) * scale + noise[2] * noise_scale;
+        state_.timestamp_ns = now_ns;
+        published_.store(state_);
+    }
+    
+    // Temperature changes slowly and is polled far less often than the
+    // encoder, so it has its own read. Heating integrates the torque over
+    // the time since the previous temperature read.
+    void readTemperature(int64_t now_ns) {
+        const double dt = temperature_ns_ < 0 ? 0.0 : (now_ns - temperature_ns_) * 1e-9;
+        state_.temperature = state_.temperature + kHeatingRate * abs(state_.torque) * dt
+                           + noise_.next(kTemperatureChannel);
+        temperature_ns_ = now_ns;
+        published_.store(state_);
+    }
+    
+    // Consistent snapshot from any thread, never blocks the writer
+    JointState getState() const {
+        return published_.load();
+    }
+    
+    void getState(JointState& out) const {
+        published_.load(out);
+    }
+    
+    void setState(const JointState& state) {
+        state_ = state;
+        published_.store(state_);
+    }
+};
+
+// Structure-of-arrays batch of IMU orientations and the gyro samples to
+// integrate into them. One lane per IMU (or per queued sample).
+struct ImuBatch {
+    AlignedArray<double> qx, qy, qz, qw;    // Orientation quaternion
+    AlignedArray<double> wx, wy, wz;        // Body angular velocity, rad/s
+    AlignedArray<double> dt;                // Seconds since the previous sample
+    
+    explicit ImuBatch(size_t lanes = 0)
+        : qx(lanes), qy(lanes), qz(lanes), qw(lanes, 1.0),
+          wx(lanes), wy(lanes), wz(lanes), dt(lanes) {}
+    
+    size_t size() const { return qx.size(); }
+    size_t paddedSize() const { return qx.capacity(); }
+};
+
+// Orientation integration kernel: q <- normalize(q * exp(w * dt / 2)).
+// The exponential map uses short Taylor series for cos(h) and sin(h)/h,
+// accurate to ~1e-9 for rotations below 0.5 rad per sample, so the AVX2 and
+// scalar paths share the same math without libm calls. Larger steps, such
+// as the first sample after a sensor gap, take the exact cos and sin
+// instead; the AVX2 path does so per lane, through the same scalar code.
+// Normalization is a correctly rounded square root and divide on both
+// paths, with the same summation order, so AVX2 and scalar results are
+// bit-identical on any x86 CPU; a reciprocal square root estimate would
+// differ between vendors.
+class ImuIntegrator {
+public:
+    // Largest squared half-angle h^2 = |w dt / 2|^2 the series handle
+    static constexpr double kSeriesMaxH2 = 0.25 * 0.25;
+    
+
+    static void integrate(ImuBatch& batch) {
+#ifdef HUMANOID_HAVE_AVX2_KERNELS
+        if (__builtin_cpu_supports("avx2")) {
+            integrateAvx2(batch);
+            return;
+        }
+#endif
+        integrateScalar(batch, 0, batch.size());
+    }
+    
+    static void integrateScalar(ImuBatch& b, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            integrateOne(b.qx[i], b.qy[i], b.qz[i], b.qw[i], b.wx[i], b.wy[i], b.wz[i], b.dt[i]);
+        }
+    }
+    
+    static void integrateOne(double& x, double& y, double& z, double& w,
+                             double wx, double wy, double wz, double dt) {
+        const double half_dt = 0.5 * dt;
+        const double vx = wx * half_dt, vy = wy * half_dt, vz = wz * half_dt;
+        const double h2 = vx * vx + vy * vy + vz * vz;
+        double c = 1.0 - h2 * (1.0 / 2.0 - h2 * (1.0 / 24.0 - h2 * (1.0 / 720.0)));
+        double sinc = 1.0 - h2 * (1.0 / 6.0 - h2 * (1.0 / 120.0 - h2 * (1.0 / 5040.0)));
+        if (h2 > kSeriesMaxH2) {
+            exactExpMap(h2, c, sinc);
+        }
+        const double a = vx * sinc, bq = vy * sinc, d = vz * sinc;
+        
+        // q * dq with q = (x, y, z, w), dq = (a, bq, d, c)
+        const double nw = w * c - x * a - y * bq - z * d;
+        const double nx = w * a + x * c + y * d - z * bq;
+        const double ny = w * bq - x * d + y * c + z * a;
+        const double nz = w * d + x * bq - y * a + z * c;
+        
+        const double inv_norm = 1.0 / std::sqrt(nx * nx + ny * ny + nz * nz + nw * nw);
+        x = nx * inv_norm;
+        y = ny * inv_norm;
+        z = nz * inv_norm;
+        w = nw * inv_norm;
+    }
+    
+    // cos(h) and sin(h)/h for a half-angle beyond the series' range
+    static void exactExpMap(double h2, double& c, double& sinc) {
+        const double h = std::sqrt(h2);
+        c = std::cos(h);
+        sinc = std::sin(h) / h;
+    }
+
+#ifdef HUMANOID_HAVE_AVX2_KERNELS
+    __attribute__((target("avx2")))
+    static void integrateAvx2(ImuBatch& b) {
+        const __m256d half = _mm256_set1_pd(0.5);
+        const __m256d one = _mm256_set1_pd(1.0);
+        const __m256d c2 = _mm256_set1_pd(1.0 / 2.0), c4 = _mm256_set1_pd(1.0 / 24.0);
+        const __m256d c6 = _mm256_set1_pd(1.0 / 720.0);
+        const __m256d s2 = _mm256_set1_pd(1.0 / 6.0), s4 = _mm256_set1_pd(1.0 / 120.0);
+        const __m256d s6 = _mm256_set1_pd(1.0 / 5040.0);
+        const __m256d series_max = _mm256_set1_pd(kSeriesMaxH2);
+        
+        // Padded lanes hold the identity quaternion and zero rates
+        for (size_t i = 0; i < b.paddedSize(); i += 4) {
+            const __m256d half_dt = _mm256_mul_pd(half, _mm256_load_pd(&b.dt[i]));
+            const __m256d vx = _mm256_mul_pd(_mm256_load_pd(&b.wx[i]), half_dt);
+            const __m256d vy = _mm256_mul_pd(_mm256_load_pd(&b.wy[i]), half_dt);
+            const __m256d vz = _mm256_mul_pd(_mm256_load_pd(&b.wz[i]), half_dt);
+            const __m256d h2 = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(vx, vx),
+                                                           _mm256_mul_pd(vy, vy)),
+                                             _mm256_mul_pd(vz, vz));
+            __m256d c = _mm256_sub_pd(one, _mm256_mul_pd(h2,
+                _mm256_sub_pd(c2, _mm256_mul_pd(h2, _mm256_sub_pd(c4, _mm256_mul_pd(h2, c6))))));
+            __m256d sinc = _mm256_sub_pd(one, _mm256_mul_pd(h2,
+                _mm256_sub_pd(s2, _mm256_mul_pd(h2, _mm256_sub_pd(s4, _mm256_mul_pd(h2, s6))))));
+            
+            // Rare: lanes whose step is too large for the series
+            const int large = _mm256_movemask_pd(_mm256_cmp_pd(h2, series_max, _CMP_GT_OQ));
+            if (large != 0) {
+                alignas(32) double h2_lanes[4], c_lanes[4], sinc_lanes[4];
+                _mm256_store_pd(h2_lanes, h2);
+                _mm256_store_pd(c_lanes, c);
+                _mm256_store_pd(sinc_lanes, sinc);
+                for (int lane = 0; lane < 4; ++lane) {
+                    if (large & (1 << lane)) {
+                        exactExpMap(h2_lanes[lane], c_lanes[lane], sinc_lanes[lane]);
+                    }
+                }
+                c = _mm256_load_pd(c_lanes);
+                sinc = _mm256_load_pd(sinc_lanes);
+            }
+            const __m256d a = _mm256_mul_pd(vx, sinc);
+            const __m256d bq = _mm256_mul_pd(vy, sinc);
+            const __m256d d = _mm256_mul_pd(vz, sinc);
+            
+            const __m256d x = _mm256_load_pd(&b.qx[i]);
+            const __m256d y = _mm256_load_pd(&b.qy[i]);
+            const __m256d z = _mm256_load_pd(&b.qz[i]);
+            const __m256d w = _mm256_load_pd(&b.qw[i]);
+            
+            const __m256d nw = _mm256_sub_pd(_mm256_sub_pd(_mm256_sub_pd(
+                _mm256_mul_pd(w, c), _mm256_mul_pd(x, a)), _mm256_mul_pd(y, bq)), _mm256_mul_pd(z, d));
+            const __m256d nx = _mm256_sub_pd(_mm256_add_pd(_mm256_add_pd(
+                _mm256_mul_pd(w, a), _mm256_mul_pd(x, c)), _mm256_mul_pd(y, d)), _mm256_mul_pd(z, bq));
+            const __m256d ny = _mm256_add_pd(_mm256_add_pd(_mm256_sub_pd(
+                _mm256_mul_pd(w, bq), _mm256_mul_pd(x, d)), _mm256_mul_pd(y, c)), _mm256_mul_pd(z, a));
+            const __m256d nz = _mm256_add_pd(_mm256_sub_pd(_mm256_add_pd(
+                _mm256_mul_pd(w, d), _mm256_mul_pd(x, bq)), _mm256_mul_pd(y, a)), _mm256_mul_pd(z, c));
+            
+            // Same order as the scalar path: ((nx^2 + ny^2) + nz^2) + nw^2
+            const __m256d n2 = _mm256_add_pd(_mm256_add_pd(_mm256_add_pd(
+                _mm256_mul_pd(nx, nx), _mm256_mul_pd(ny, ny)), _mm256_mul_pd(nz, nz)),
+                _mm256_mul_pd(nw, nw));
+            const __m256d r = _mm256_div_pd(one, _mm256_sqrt_pd(n2));
+            
+            _mm256_store_pd(&b.qx[i], _mm256_mul_pd(nx, r));
+            _mm256_store_pd(&b.qy[i], _mm256_mul_pd(ny, r));
+            _mm256_store_pd(&b.qz[i], _mm256_mul_pd(nz, r));
+            _mm256_store_pd(&b.qw[i], _mm256_mul_pd(nw, r));
+        }
+    }
+#endif
+};
+
+// IMU sensor class. sample() takes the raw gyro/accelerometer reading;
+// orientation is integrated from it either by read() for this sensor alone
+// or by ImuIntegrator over a batch of sensors.
+class ImuSensor : public Sensor {
+private:
+    ImuData data_;                      // Writer-side working copy
+    SeqLock<ImuData> published_;        // Lock-free snapshot for readers
+    double sample_interval_;            // Seconds between the last two samples
+    bool has_sample_;
+
+public:
+    ImuSensor(const std::string& name, double noise_level = 0.001) 
+        : Sensor(name, noise_level), published_(data_),
+          sample_interval_(0.0), has_sample_(false) {}
+    
+    void read(int64_t now_ns) override {
+        sample(now_ns);
+        ImuIntegrator::integrateOne(data_.orientation[0], data_.orientation[1],
+                                    data_.orientation[2], data_.orientation[3],
+                                    data_.angular_velocity[0], data_.angular_velocity[1],
+                                    data_.angular_velocity[2], sample_interval_);
+        publish();
+    }
+    
+    // Raw reading and timestamp; the orientation is left for the integrator
+    void sample(int64_t now_ns) {
+        const double t = now_ns * 1e-9;
+        
+        // In a real system, this would interface with IMU hardware
+        // For simulation, we'll generate realistic values
+        data_.angular_velocity[0] = addNoise(0.1 * sin(t));
+        data_.angular_velocity[1] = addNoise(0.05 * sin(t * 1.5), 1);
+        data_.linear_acceleration[2] = addNoise(9.81 + 0.1 * cos(t * 0.5), 2);
+        
+        sample_interval_ = has_sample_ ? (now_ns - data_.timestamp_ns) * 1e-9 : 0.0;
+        data_.timestamp_ns = now_ns;
+        has_sample_ = true;
+    }
+    
+    double sampleInterval() const { return sample_interval_; }
+    
+    // Writer-side access for batched integration
+    ImuData& workingData() { return data_; }
+    
+    void publish() {
+        published_.store(data_);
+    }
+    
+    ImuData getData() const {
+        return published_.load();
+    }
+    
+    void getData(ImuData& out) const {
+        published_.load(out);
+    }
+};
+
+#endif  // HUMANOID_CONTROL_SENSORS_HPP
@@ -0,0 +1,354 @@
+// Joint and IMU state, structure-of-arrays storage and lock-free primitives
+
+#ifndef HUMANOID_CONTROL_STATE_HPP
+#define HUMANOID_CONTROL_STATE_HPP
+
+#include "humanoid_control/core.hpp"
+
+// Data structures for sensor readings
+struct JointState {
+    double position = 0.0;      // Radians
+    double velocity = 0.0;      // Rad/s
+    double torque = 0.0;        // Nm
+    double temperature = 25.0;  // Celsius
+    int64_t timestamp_ns = 0;   // steady_clock nanoseconds (cycle time)
+};
+
+struct ImuData {
+    double orientation[4] = {0, 0, 0, 1};  // Quaternion [x, y, z, w]
+    double angular_velocity[3] = {0, 0, 0}; // Rad/s [x, y, z]
+    double linear_acceleration[3] = {0, 0, 9.81}; // m/s^2 [x, y, z]
+    int64_t timestamp_ns = 0;   // steady_clock nanoseconds (cycle time)
+};
+
+// Cache-line aligned, fixed-capacity array for structure-of-arrays storage.
+// Capacity is rounded up to whole cache lines so vector kernels can run over
+// the padded length without a remainder loop.
+constexpr size_t kCacheLineSize = 64;
+
+template <typename T>
+class AlignedArray {
+private:
+    T* data_;
+    size_t size_;
+    size_t capacity_;
+
+public:
+    explicit AlignedArray(size_t size = 0, T value = T())
+        : data_(nullptr), size_(size), capacity_(paddedCount(size)) {
+        if (capacity_ > 0) {
+            data_ = static_cast<T*>(::operator new(capacity_ * sizeof(T),
+                                                   std::align_val_t(kCacheLineSize)));
+            std::fill(data_, data_ + capacity_, value);
+        }
+    }
+    
+    ~AlignedArray() {
+        if (data_) {
+            ::operator delete(data_, std::align_val_t(kCacheLineSize));
+        }
+    }
+    
+    AlignedArray(const AlignedArray&) = delete;
+    AlignedArray& operator=(const AlignedArray&) = delete;
+    
+    AlignedArray(AlignedArray&& other) noexcept
+        : data_(other.data_), size_(other.size_), capacity_(other.capacity_) {
+        other.data_ = nullptr;
+        other.size_ = other.capacity_ = 0;
+    }
+    
+    AlignedArray& operator=(AlignedArray&& other) noexcept {
+        std::swap(data_, other.data_);
+        std::swap(size_, other.size_);
+        std::swap(capacity_, other.capacity_);
+        return *this;
+    }
+    
+    T& operator[](size_t i) { return data_[i]; }
+    const T& operator[](size_t i) const { return data_[i]; }
+    T* data() { return data_; }
+    const T* data() const { return data_; }
+    size_t size() const { return size_; }
+    size_t capacity() const { return capacity_; }
+    
+    static size_t paddedCount(size_t count) {
+        constexpr size_t per_line = kCacheLineSize / sizeof(T);
+        return (count + per_line - 1) / per_line * per_line;
+    }
+};
+
+// Structure-of-arrays joint state for all joints. Each field is a contiguous,
+// cache-line aligned array indexed by joint, so a per-cycle sweep is a linear
+// pass. Written by the control thread only; no locking.
+class JointStateBank {
+private:
+    size_t size_;
+    AlignedArray<double> position_;
+    AlignedArray<double> velocity_;
+    AlignedArray<double> torque_;
+    AlignedArray<double> temperature_;
+    AlignedArray<int64_t> timestamp_ns_;   // steady_clock, nanoseconds
+
+public:
+    explicit JointStateBank(size_t joints)
+        : size_(joints), position_(joints), velocity_(joints), torque_(joints),
+          temperature_(joints, 25.0), timestamp_ns_(joints) {}
+    
+    size_t size() const { return size_; }
+    size_t paddedSize() const { return position_.capacity(); }
+    
+    double* position() { return position_.data(); }
+    double* velocity() { return velocity_.data(); }
+    double* torque() { return torque_.data(); }
+    double* temperature() { return temperature_.data(); }
+    int64_t* timestampNs() { return timestamp_ns_.data(); }
+    
+    const double* position() const { return position_.data(); }
+    const double* velocity() const { return velocity_.data(); }
+    const double* torque() const { return torque_.data(); }
+    const double* temperature() const { return temperature_.data(); }
+    const int64_t* timestampNs() const { return timestamp_ns_.data(); }
+    
+    void store(size_t joint, const JointState& state) {
+        position_[joint] = state.position;
+        velocity_[joint] = state.velocity;
+        torque_[joint] = state.torque;
+        temperature_[joint] = state.temperature;
+        timestamp_ns_[joint] = state.timestamp_ns;
+    }
+    
+    JointState load(size_t joint) const {
+        JointState state;
+        state.position = position_[joint];
+        state.velocity = velocity_[joint];
+        state.torque = torque_[joint];
+        state.temperature = temperature_[joint];
+        state.timestamp_ns = timestamp_ns_[joint];
+        return state;
+    }
+};
+
+// Single-writer sequence lock. The writer never blocks; readers retry if
+// they overlap a write and otherwise get a consistent copy without taking a
+// lock, so a monitoring thread can never delay the writer (no priority
+// inversion). The payload is copied through relaxed atomic words, which
+// keeps concurrent reads well-defined.
+template <typename T>
+class SeqLock {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "SeqLock payload must be trivially copyable");
+    static constexpr size_t kWords = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    alignas(kCacheLineSize) std::atomic<uint64_t> sequence_;
+    std::array<std::atomic<uint64_t>, kWords> words_;
+
+public:
+    explicit SeqLock(const T& initial) : sequence_(0) {
+        uint64_t buffer[kWords] = {};
+        std::memcpy(buffer, &initial, sizeof(T));
+        for (size_t i = 0; i < kWords; ++i) {
+            words_[i].store(buffer[i], std::memory_order_relaxed);
+        }
+    }
+    
+    SeqLock(const SeqLock&) = delete;
+    SeqLock& operator=(const SeqLock&) = delete;
+    
+    // Writer side; only one thread may call this
+    void store(const T& value) {
+        uint64_t buffer[kWords] = {};
+        std::memcpy(buffer, &value, sizeof(T));
+        
+        const uint64_t seq = sequence_.load(std::memory_order_relaxed);
+        sequence_.store(seq + 1, std::memory_order_relaxed);   // Odd: write in progress
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < kWords; ++i) {
+            words_[i].store(buffer[i], std::memory_order_relaxed);
+        }
+        sequence_.store(seq + 2, std::memory_order_release);
+    }
+    
+    // Reader side; any number of threads
+    void load(T& out) const {
+        uint64_t buffer[kWords];
+        while (true) {
+            const uint64_t before = sequence_.load(std::memory_order_acquire);
+            if (before & 1) {
+                Utils::cpu_relax();
+                continue;
+            }
+            for (size_t i = 0; i < kWords; ++i) {
+                buffer[i] = words_[i].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (sequence_.load(std::memory_order_relaxed) == before) {
+                break;
+            }
+        }
+        std::memcpy(&out, buffer, sizeof(T));
+    }
+    
+    T load() const {
+        T out;
+        load(out);
+        return out;
+    }
+};
+
+// Bounded single-producer/single-consumer ring. push and pop are wait-free:
+// each side owns one index and only reads the other's. A full ring rejects
+// the new element and counts the drop rather than blocking the producer.
+template <typename T, size_t Capacity>
+class SpscRing {
+    static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+    static constexpr size_t kMask = Capacity - 1;
+
+    alignas(kCacheLineSize) std::atomic<size_t> head_;    // Next slot to read (consumer)
+    alignas(kCacheLineSize) std::atomic<size_t> tail_;    // Next slot to write (producer)
+    alignas(kCacheLineSize) std::atomic<uint64_t> dropped_;
+    std::array<T, Capacity> slots_;
+
+public:
+    SpscRing() : head_(0), tail_(0), dropped_(0) {}
+    
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+    
+    // Producer side
+    bool tryPush(const T& value) {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_.load(std::memory_order_acquire) == Capacity) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        slots_[tail & kMask] = value;
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+    
+    // Consumer side
+    bool tryPop(T& out) {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        if (head == tail_.load(std::memory_order_acquire)) {
+            return false;
+        }
+        out = slots_[head & kMask];
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+    
+    // Consumer side: hand every available element to fn in one batch and
+    // release the slots with a single index update
+    template <typename Fn>
+    size_t drain(Fn&& fn, size_t max_items = Capacity) {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        const size_t available = tail_.load(std::memory_order_acquire) - head;
+        const size_t count = std::min(available, max_items);
+        for (size_t i = 0; i < count; ++i) {
+            fn(static_cast<const T&>(slots_[(head + i) & kMask]));
+        }
+        head_.store(head + count, std::memory_order_release);
+        return count;
+    }
+    
+    size_t size() const {
+        return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire);
+    }
+    
+    static constexpr size_t capacity() { return Capacity; }
+    uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+};
+
+// Bounded multi-producer/single-consumer ring. Each slot carries a
+// sequence number that says whether it is free for the producer of that
+// lap or filled for the consumer, so producers claim slots with one
+// compare-and-swap on the tail and never wait for each other or for the
+// consumer: lock-free, with no lock for a preempted producer to hold. A
+// full ring rejects the new element and counts the drop. The consumer
+// stops at a slot that is claimed but not yet filled and picks it up on
+// its next drain.
+template <typename T, size_t Capacity>
+class MpscRing {
+    static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+    static constexpr size_t kMask = Capacity - 1;
+    
+    struct Slot {
+        std::atomic<size_t> sequence;   // Lap position: tail when free, tail + 1 when filled
+        T value;
+    };
+
+    alignas(kCacheLineSize) std::atomic<size_t> head_;    // Next slot to read (consumer)
+    alignas(kCacheLineSize) std::atomic<size_t> tail_;    // Next slot to claim (producers)
+    alignas(kCacheLineSize) std::atomic<uint64_t> dropped_;
+    std::array<Slot, Capacity> slots_;
+
+public:
+    MpscRing() : head_(0), tail_(0), dropped_(0) {
+        for (size_t i = 0; i < Capacity; ++i) {
+            slots_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+    
+    MpscRing(const MpscRing&) = delete;
+    MpscRing& operator=(const MpscRing&) = delete;
+    
+    // Producer side, any thread
+    bool tryPush(const T& value) {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        while (true) {
+            Slot& slot = slots_[tail & kMask];
+            const size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            if (sequence == tail) {
+                // Free for this lap; a failed claim reloads tail
+                if (tail_.compare_exchange_weak(tail, tail + 1, std::memory_order_relaxed)) {
+                    slot.value = value;
+                    slot.sequence.store(tail + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (static_cast<std::make_signed_t<size_t>>(sequence - tail) < 0) {
+                // Still holds the previous lap's element: full
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            } else {
+                // Another producer claimed it first
+                tail = tail_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+    
+    // Consumer side: hand every filled element to fn, oldest first
+    template <typename Fn>
+    size_t drain(Fn&& fn, size_t max_items = Capacity) {
+        size_t head = head_.load(std::memory_order_relaxed);
+        size_t count = 0;
+        while (count < max_items) {
+            Slot& slot = slots_[head & kMask];
+            if (slot.sequence.load(std::memory_order_acquire) != head + 1) {
+                break;
+            }
+            fn(static_cast<const T&>(slot.value));
+            slot.sequence.store(head + Capacity, std::memory_order_release);
+            ++head;
+            ++count;
+        }
+        head_.store(head, std::memory_order_relaxed);
+        return count;
+    }
+    
+    static constexpr size_t capacity() { return Capacity; }
+    uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+};
+
+// Timestamped samples carried from acquisition to fusion
+struct JointSample {
+    uint32_t joint;
+    JointState state;
+};
+
+struct ImuSample {
+    uint32_t imu;
+    ImuData data;
+};
+
+#endif  // HUMANOID_CONTROL_STATE_HPP
@@ -0,0 +1,278 @@
+// Humanoid controller for a topology fixed at compile time
+
+#ifndef HUMANOID_CONTROL_STATIC_CONTROLLER_HPP
+#define HUMANOID_CONTROL_STATIC_CONTROLLER_HPP
+
+#include "humanoid_control/core.hpp"
+#include "humanoid_control/state.hpp"
+#include "humanoid_control/logging.hpp"
+#include "humanoid_control/sensors.hpp"
+#include "humanoid_control/actuation.hpp"
+#include "humanoid_control/joint_control.hpp"
+#include "humanoid_control/fusion.hpp"
+#include "humanoid_control/safety_monitor.hpp"
+#include "humanoid_control/control_loop.hpp"
+
+#include <utility>
+
+enum class JointRole : uint8_t {
+    Hip,
+    Knee,
+    Ankle,
+};
+
+struct JointSpec {
+    const char* name;
+    JointRole role;
+};
+
+// Robot descriptions for StaticHumanoidController provide:
+//   static constexpr std::array<JointSpec, N> kJoints;
+//   static constexpr std::array<const char*, M> kImus;
+//   static constexpr size_t kTorsoImu;     // Index into kImus, feeds the EKF
+// This one is the six-joint biped HumanoidController builds by default.
+struct SixJointBiped {
+    static constexpr std::array<JointSpec, 6> kJoints = {{
+        {"left_hip", JointRole::Hip},
+        {"left_knee", JointRole::Knee},
+        {"left_ankle", JointRole::Ankle},
+        {"right_hip", JointRole::Hip},
+        {"right_knee", JointRole::Knee},
+        {"right_ankle", JointRole::Ankle},
+    }};
+    static constexpr std::array<const char*, 2> kImus = {{"torso_imu", "head_imu"}};
+    static constexpr size_t kTorsoImu = 0;
+};
+
+// HumanoidController for robots whose topology never changes. Joint and
+// IMU counts and joint roles come from Robot as constants, so sensors,
+// controllers and per-cycle samples live in std::array, every per-joint
+// loop is unrolled with a fixed trip count, and role-specific work (hip
+// angles and the torso IMU feeding the balance EKF) is selected at compile
+// time instead of by name at run time. Sensors are read inline on the
+// control thread. The loop, its stage rates and its summary come from
+// ControlLoop, and the SoA banks keep their aligned heap storage, sized
+// once from the constants, so the batched PID and safety kernels are
+// shared with HumanoidController too.
+template <typename Robot>
+class StaticHumanoidController : public ControlLoop<StaticHumanoidController<Robot>> {
+    using Loop = ControlLoop<StaticHumanoidController<Robot>>;
+    using Tick = typename Loop::Tick;
+    using Loop::rates_;
+    using Loop::scheduler_;
+    using Loop::cycle_arena_;
+    friend Loop;
+
+public:
+    static constexpr size_t kJointCount = Robot::kJoints.size();
+    static constexpr size_t kImuCount = Robot::kImus.size();
+
+private:
+    static constexpr size_t countRole(JointRole role) {
+        size_t count = 0;
+        for (const JointSpec& joint : Robot::kJoints) {
+            count += joint.role == role;
+        }
+        return count;
+    }
+    
+    // index-th joint with this role
+    static constexpr size_t findRole(JointRole role, size_t index) {
+        for (size_t j = 0; j < kJointCount; ++j) {
+            if (Robot::kJoints[j].role == role && index-- == 0) return j;
+        }
+        return kJointCount;
+    }
+    
+    static_assert(kJointCount > 0, "robot description has no joints");
+    static_assert(Robot::kTorsoImu < kImuCount, "kTorsoImu is not one of kImus");
+    static_assert(countRole(JointRole::Hip) >= 2, "status line needs a left and a right hip");
+    
+    // Joints shown on the status line
+    static constexpr size_t kLeftHip = findRole(JointRole::Hip, 0);
+    static constexpr size_t kRightHip = findRole(JointRole::Hip, 1);
+    
+    // Call fn(std::integral_constant<size_t, I>) for I in [0, N)
+    template <size_t N, typename Fn>
+    static void unroll(Fn&& fn) {
+        unrollImpl(fn, std::make_index_sequence<N>{});
+    }
+    
+    template <typename Fn, size_t... I>
+    static void unrollImpl(Fn& fn, std::index_sequence<I...>) {
+        (fn(std::integral_constant<size_t, I>{}), ...);
+    }
+    
+    JointStateBank joint_state_bank_;
+    PidBank pid_bank_;
+    PidKernel pid_kernel_;
+    AlignedArray<double> torque_commands_;
+    SafetyLimits safety_limits_;
+    
+    std::array<JointController, kJointCount> joint_controllers_;
+    std::array<JointSensor, kJointCount> joint_sensors_;
+    std::array<ImuSensor, kImuCount> imu_sensors_;
+    std::array<JointState, kJointCount> joint_samples_;
+    NoiseBank joint_noise_;     // Lanes are (joint, channel) pairs, as in SensorAcquisition
+    alignas(kCacheLineSize) std::array<double, kJointCount * JointSensor::kNoiseChannels> joint_noise_values_;
+    std::array<ImuData, kImuCount> imu_samples_;
+    
+    BalanceEkf balance_ekf_;
+    double balance_;
+    EmergencyStop estop_;
+    SafetyMonitor safety_monitor_;
+    CommandBus command_bus_;  // Declared after the joints so it stops first
+    SafetyWatchdog watchdog_; // Declared after the bus so it stops first
+    
+    template <size_t... J>
+    std::array<JointController, kJointCount> makeControllers(std::index_sequence<J...>) {
+        return {{JointController(Robot::kJoints[J].name, joint_state_bank_, pid_bank_,
+                                 safety_limits_, J)...}};
+    }
+    
+    template <size_t... J>
+    static std::array<JointSensor, kJointCount> makeJointSensors(std::index_sequence<J...>) {
+        return {{JointSensor(std::string(Robot::kJoints[J].name) + "_pos_sensor")...}};
+    }
+    
+    template <size_t... I>
+    static std::array<ImuSensor, kImuCount> makeImuSensors(std::index_sequence<I...>) {
+        return {{ImuSensor(Robot::kImus[I])...}};
+    }
+
+public:
+    explicit StaticHumanoidController(double frequency = 100.0)
+        : Loop(frequency),
+          joint_state_bank_(kJointCount),
+          pid_bank_(kJointCount),
+          pid_kernel_(kJointCount),
+          torque_commands_(kJointCount),
+          safety_limits_(kJointCount),
+          joint_controllers_(makeControllers(std::make_index_sequence<kJointCount>{})),
+          joint_sensors_(makeJointSensors(std::make_index_sequence<kJointCount>{})),
+          imu_sensors_(makeImuSensors(std::make_index_sequence<kImuCount>{})),
+          joint_samples_(), joint_noise_(kJointCount * JointSensor::kNoiseChannels),
+          joint_noise_values_(), imu_samples_(), balance_(0.0),
+          safety_monitor_(joint_state_bank_, safety_limits_, estop_),
+          watchdog_(estop_, safety_monitor_, command_bus_,
+                    SafetyWatchdog::Options::forRates(frequency, frequency)) {
+        
+        for (auto& controller : joint_controllers_) {
+            controller.attachBus(command_bus_);
+            safety_monitor_.addController(&controller);
+        }
+        for (auto& sensor : joint_sensors_) {
+            safety_monitor_.addJointSensor(&sensor);
+        }
+        for (auto& sensor : imu_sensors_) {
+            safety_monitor_.addImuSensor(&sensor);
+        }
+        this->setNoiseSeed(Noise::kDefaultSeed);
+    }
+    
+    double balanceEstimate() const { return balance_; }
+    const double* torqueCommands() const { return torque_commands_.data(); }
+    JointSensor& jointSensor(size_t joint) { return joint_sensors_[joint]; }
+
+private:
+    // ControlLoop hooks. Everything runs on the control thread, so there
+    // is nothing to start or stop around the loop.
+    void configureStages() {
+        using Stage = CycleInstrumentation::Stage;
+        scheduler_.addTask(Loop::stageTask("imu", rates_.imu, Stage::SensorRead),
+                           [this](const Tick& tick) { readImus(tick.wake_ns); });
+        scheduler_.addTask(Loop::stageTask("joints", rates_.joints, Stage::SensorRead),
+                           [this](const Tick& tick) { readJoints(tick.wake_ns); });
+        scheduler_.addTask(Loop::stageTask("temperature", rates_.temperature, Stage::SensorRead),
+                           [this](const Tick& tick) { readTemperatures(tick.wake_ns); });
+        scheduler_.addTask(Loop::stageTask("balance", rates_.balance, Stage::Fusion),
+                           [this](const Tick&) { updateBalance(); });
+        scheduler_.addTask(this->controlTask("control", rates_.control_budget_ns, Stage::Control),
+                           [this](const Tick& tick) { controlStage(tick); });
+        scheduler_.addTask(Loop::stageTask("safety", rates_.safety, Stage::Safety),
+                           [this](const Tick& tick) {
+                               safety_monitor_.checkSafety(tick.wake_ns, cycle_arena_);
+                           });
+    }
+    
+    // Read every sensor once so the first safety check sees fresh samples
+    void primeSensors(int64_t now_ns) {
+        readTemperatures(now_ns);
+        readJoints(now_ns);
+        readImus(now_ns);
+        updateBalance();
+    }
+    
+    // Same streams as SensorAcquisition::seedJointNoise
+    void seedJointNoise(uint64_t seed) {
+        const size_t channels = JointSensor::kNoiseChannels;
+        for (size_t j = 0; j < kJointCount; ++j) {
+            for (size_t ch = 0; ch < channels; ++ch) {
+                joint_noise_.seedLane(j * channels + ch,
+                                      Noise::streamSeed(seed, joint_sensors_[j].getName(), ch),
+                                      joint_sensors_[j].getNoiseLevel());
+            }
+        }
+    }
+    
+    void startRun(bool) {}
+    void finishRun() {}
+    
+    void logStatus(int64_t now_ns) {
+        AsyncLogger::instance().log(LogEvent::Status,
+            now_ns * 1e-9,
+            joint_samples_[kLeftHip].position,
+            joint_samples_[kRightHip].position,
+            balance_,
+            estop_.isActive() ? "EMERGENCY" : "OK");
+    }
+    
+    // Temperatures change slowly; the next encoder samples carry them
+    void readTemperatures(int64_t now_ns) {
+        unroll<kJointCount>([&](auto j) {
+            joint_sensors_[j].readTemperature(now_ns);
+        });
+    }
+    
+    void readJoints(int64_t now_ns) {
+        joint_noise_.fill(joint_noise_values_.data());
+        unroll<kJointCount>([&](auto j) {
+            joint_sensors_[j].read(now_ns, &joint_noise_values_[j * JointSensor::kNoiseChannels]);
+            joint_sensors_[j].getState(joint_samples_[j]);
+            joint_state_bank_.store(j, joint_samples_[j]);
+        });
+    }
+    
+    void readImus(int64_t now_ns) {
+        unroll<kImuCount>([&](auto i) {
+            imu_sensors_[i].read(now_ns);
+            imu_sensors_[i].getData(imu_samples_[i]);
+        });
+    }
+    
+    // Hip angles and the torso IMU feed the balance EKF; which joints and
+    // IMU those are is known here at compile time
+    void updateBalance() {
+        unroll<kJointCount>([this](auto j) {
+            if constexpr (Robot::kJoints[decltype(j)::value].role == JointRole::Hip) {
+                balance_ekf_.updateHip(joint_samples_[j].position, joint_samples_[j].timestamp_ns);
+            }
+        });
+        const ImuData& torso = imu_samples_[Robot::kTorsoImu];
+        balance_ekf_.updateImu(torso.angular_velocity, torso.linear_acceleration,
+                               torso.timestamp_ns);
+        balance_ = balance_ekf_.roll();
+    }
+    
+    // One batched PID pass, then all staged torques in one bus transaction
+    void controlStage(const Tick& tick) {
+        pid_kernel_.step(pid_bank_, joint_state_bank_, tick.period_ns * 1e-9,
+                         torque_commands_.data());
+        unroll<kJointCount>([this](auto j) {
+            joint_controllers_[j].stageCommand(torque_commands_[j]);
+        });
+        command_bus_.publish();
+    }
+};
+
+#endif  // HUMANOID_CONTROL_STATIC_CONTROLLER_HPP
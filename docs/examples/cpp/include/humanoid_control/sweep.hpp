@@ -0,0 +1,231 @@
+// Parallel Monte Carlo parameter sweeps
+
+#ifndef HUMANOID_CONTROL_SWEEP_HPP
+#define HUMANOID_CONTROL_SWEEP_HPP
+
+#include "humanoid_control/core.hpp"
+#include "humanoid_control/state.hpp"
+#include "humanoid_control/logging.hpp"
+#include "humanoid_control/sensors.hpp"
+#include "humanoid_control/actuation.hpp"
+#include "humanoid_control/humanoid_controller.hpp"
+
+// Fixed pool of workers, each with its own deque of task indices. A worker
+// pops from the back of its own deque and, once that is empty, steals from
+// the front of another's, so uneven task costs even out without a shared
+// queue. Tasks are whole simulations, so the per-deque locks are taken a
+// handful of times per task and never contend in the steady state.
+class WorkStealingPool {
+private:
+    struct alignas(kCacheLineSize) Worker {
+        std::mutex mutex;
+        std::deque<size_t> tasks;
+    };
+    
+    size_t worker_count_;
+    std::unique_ptr<Worker[]> workers_;
+    std::atomic<uint64_t> steals_;
+
+public:
+    explicit WorkStealingPool(size_t workers)
+        : worker_count_(std::max<size_t>(workers, 1)),
+          workers_(new Worker[std::max<size_t>(workers, 1)]), steals_(0) {}
+    
+    size_t workerCount() const { return worker_count_; }
+    uint64_t steals() const { return steals_.load(std::memory_order_relaxed); }
+    
+    // Run fn(worker, task) for every task in [0, task_count) and wait for
+    // all of them. Each worker starts with a contiguous block of tasks.
+    template <typename Fn>
+    void run(size_t task_count, Fn&& fn) {
+        for (size_t w = 0; w < worker_count_; ++w) {
+            const size_t begin = task_count * w / worker_count_;
+            const size_t end = task_count * (w + 1) / worker_count_;
+            std::lock_guard<std::mutex> lock(workers_[w].mutex);
+            workers_[w].tasks.clear();
+            for (size_t t = begin; t < end; ++t) {
+                workers_[w].tasks.push_back(t);
+            }
+        }
+        
+        std::vector<std::thread> threads;
+        threads.reserve(worker_count_ - 1);
+        for (size_t w = 1; w < worker_count_; ++w) {
+            threads.emplace_back([this, w, &fn] { workerLoop(w, fn); });
+        }
+        workerLoop(0, fn);
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+
+private:
+    template <typename Fn>
+    void workerLoop(size_t self, Fn& fn) {
+        size_t task;
+        while (popLocal(self, task) || steal(self, task)) {
+            fn(self, task);
+        }
+    }
+    
+    bool popLocal(size_t self, size_t& task) {
+        Worker& worker = workers_[self];
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        if (worker.tasks.empty()) return false;
+        task = worker.tasks.back();
+        worker.tasks.pop_back();
+        return true;
+    }
+    
+    // No task is ever added during run(), so finding every deque empty
+    // means the run is done
+    bool steal(size_t self, size_t& task) {
+        for (size_t i = 1; i < worker_count_; ++i) {
+            Worker& victim = workers_[(self + i) % worker_count_];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.tasks.empty()) {
+                task = victim.tasks.front();
+                victim.tasks.pop_front();
+                steals_.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+// Streaming mean/variance/min/max (Welford), mergeable across workers with
+// Chan's parallel update
+class RunningStats {
+private:
+    uint64_t count_;
+    double mean_;
+    double m2_;
+    double min_;
+    double max_;
+
+public:
+    RunningStats() : count_(0), mean_(0.0), m2_(0.0), min_(INFINITY), max_(-INFINITY) {}
+    
+    void add(double x) {
+        ++count_;
+        const double delta = x - mean_;
+        mean_ += delta / count_;
+        m2_ += delta * (x - mean_);
+        min_ = std::min(min_, x);
+        max_ = std::max(max_, x);
+    }
+    
+    void merge(const RunningStats& other) {
+        if (other.count_ == 0) return;
+        if (count_ == 0) {
+            *this = other;
+            return;
+        }
+        const uint64_t total = count_ + other.count_;
+        const double delta = other.mean_ - mean_;
+        mean_ += delta * other.count_ / total;
+        m2_ += other.m2_ + delta * delta * (static_cast<double>(count_) * other.count_ / total);
+        count_ = total;
+        min_ = std::min(min_, other.min_);
+        max_ = std::max(max_, other.max_);
+    }
+    
+    uint64_t count() const { return count_; }
+    double mean() const { return mean_; }
+    double variance() const { return count_ > 1 ? m2_ / (count_ - 1) : 0.0; }
+    double stddev() const { return std::sqrt(variance()); }
+    double min() const { return min_; }
+    double max() const { return max_; }
+};
+
+// Monte Carlo parameter sweep. Every run is an independent controller on
+// virtual time, with the loop closed through a simple joint plant
+// (inertia plus viscous damping driven by the torque the actuators apply),
+// so gains actually change the outcome. Run i is seeded from the sweep
+// seed and i alone, so a run's metrics do not depend on which worker ran
+// it or in what order. Each run's metrics go to their own slot and are
+// folded into the aggregates in run order once every run is done, so the
+// summary is bit-identical for any thread count. Workers mute their own
+// log output while they simulate. Each run builds and tears down its
+// controller on the global heap, so workers share the allocator while a
+// run starts and ends; the simulation in between does not allocate.
+struct SweepParameters {
+    double kp = 100.0;
+    double ki = 10.0;
+    double kd = 5.0;
+    double noise_sigma = 0.01;
+    double velocity_limit = 5.0;
+};
+
+struct SweepOptions {
+    double frequency = 1000.0;          // Control rate, Hz
+    double duration = 2.0;              // Simulated seconds per run
+    uint64_t seed = Noise::kDefaultSeed;
+    size_t threads = 0;                 // 0: one per hardware thread
+    double target_position = 0.3;       // Step target for every joint, rad
+    double inertia = 0.05;              // Plant, kg m^2
+    double damping = 0.5;               // Plant, Nm s/rad
+    double trip_penalty = 10.0;         // Added to the score of a run that e-stopped
+};
+
+struct SweepRunMetrics {
+    size_t run = 0;
+    uint64_t seed = 0;
+    SweepParameters parameters;
+    uint64_t cycles = 0;
+    double rms_tracking_error = 0.0;    // rad, over all joints and cycles
+    double max_tracking_error = 0.0;    // rad
+    uint64_t budget_overruns = 0;       // Cycles whose compute exceeded the period
+                                        // (wall clock, so not reproducible)
+    bool tripped = false;
+    double trip_time = 0.0;             // Simulated seconds
+    double score = INFINITY;            // Lower is better
+};
+
+struct SweepSummary {
+    size_t runs = 0;
+    size_t trips = 0;
+    RunningStats rms_tracking_error;
+    RunningStats max_tracking_error;
+    RunningStats budget_overruns;
+    RunningStats score;
+    SweepRunMetrics best;
+    std::vector<SweepRunMetrics> run_metrics;   // By run index
+    uint64_t steals = 0;
+    double wall_seconds = 0.0;
+};
+
+class SweepRunner {
+public:
+    static uint64_t runSeed(uint64_t sweep_seed, size_t run) {
+        uint64_t state = sweep_seed ^ (static_cast<uint64_t>(run) * 0x9e3779b97f4a7c15ULL);
+        return Noise::splitmix64(state);
+    }
+    
+    static SweepSummary run(const std::vector<SweepParameters>& grid, const SweepOptions& options);
+    
+    // One simulated run; deterministic for a given (parameters, options, run)
+    static SweepRunMetrics runOne(const SweepParameters& parameters, const SweepOptions& options,
+                                  size_t run);
+
+private:
+    // Ties go to the lower run index, so the best run is deterministic
+    static bool better(const SweepRunMetrics& a, const SweepRunMetrics& b) {
+        return a.score < b.score || (a.score == b.score && a.run < b.run);
+    }
+    
+    static void accumulate(SweepSummary& summary, const SweepRunMetrics& metrics) {
+        summary.runs++;
+        summary.trips += metrics.tripped ? 1 : 0;
+        summary.rms_tracking_error.add(metrics.rms_tracking_error);
+        summary.max_tracking_error.add(metrics.max_tracking_error);
+        summary.budget_overruns.add(static_cast<double>(metrics.budget_overruns));
+        summary.score.add(metrics.score);
+        if (summary.runs == 1 || better(metrics, summary.best)) {
+            summary.best = metrics;
+        }
+    }
+};
+
+#endif  // HUMANOID_CONTROL_SWEEP_HPP
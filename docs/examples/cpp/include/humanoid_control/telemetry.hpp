@@ -0,0 +1,253 @@
+// Full-rate telemetry recording and playback
+
+#ifndef HUMANOID_CONTROL_TELEMETRY_HPP
+#define HUMANOID_CONTROL_TELEMETRY_HPP
+
+#include "humanoid_control/core.hpp"
+#include "humanoid_control/state.hpp"
+#include "humanoid_control/actuation.hpp"
+#include "humanoid_control/joint_control.hpp"
+#include "humanoid_control/fusion.hpp"
+
+// Full-rate binary telemetry. Every cycle's joint states, commanded
+// torques, IMU data and balance estimate go into a fixed-size record in a
+// ring of preallocated, memory-mapped segment files. All files are created,
+// sized and mapped by open(), so record() only copies the SoA arrays
+// straight into the mapping: no intermediate buffer, no allocation, no
+// syscall. When a segment fills, recording moves on to the next one and the
+// oldest is overwritten, so the footprint stays at segment_count *
+// segment_bytes however long the robot runs. A background thread msyncs
+// finished segments.
+//
+// Segment layout: one page of TelemetrySegmentHeader, then record_count
+// records of record_bytes each:
+//   TelemetryRecordHeader
+//   double position[joints], velocity[joints], torque[joints],
+//          temperature[joints], command[joints]
+//   int64_t timestamp_ns[joints]       // Sample time, for stale checks
+//   ImuData imu[imus]
+struct TelemetrySegmentHeader {
+    static constexpr uint32_t kVersion = 2;
+    char magic[8];                      // "HUMTLM1"
+    uint32_t version;
+    uint32_t header_bytes;              // Offset of the first record
+    uint32_t record_bytes;
+    uint32_t joint_count;
+    uint32_t imu_count;
+    uint32_t reserved;
+    uint64_t sequence;                  // Orders segments after wrap-around
+    uint64_t capacity;                  // Records that fit in this segment
+    std::atomic<uint64_t> record_count; // Valid records, updated per record
+};
+
+struct TelemetryRecordHeader {
+    uint64_t cycle;
+    int64_t time_ns;
+    double balance;
+    uint32_t violations;                // SafetyKernel mask
+    uint32_t estop_reasons;             // EmergencyStop reasons
+};
+
+class TelemetryRecorder {
+public:
+    struct Options {
+        std::string directory = ".";
+        std::string prefix = "telemetry";
+        size_t segment_count = 4;
+        size_t segment_bytes = 16 << 20;
+        int64_t sync_period_ns = 100000000;   // Background msync poll
+    };
+    
+    static constexpr size_t kHeaderBytes = 4096;
+    static_assert(sizeof(TelemetrySegmentHeader) <= kHeaderBytes, "segment header too large");
+
+private:
+    struct Segment {
+        unsigned char* base = nullptr;
+        TelemetrySegmentHeader* header = nullptr;
+        std::string path;
+    };
+    
+    Options options_;
+    std::vector<Segment> segments_;
+    size_t joint_count_;
+    size_t imu_count_;
+    size_t record_bytes_;
+    uint64_t capacity_;
+    
+    // Control thread only
+    size_t active_;
+    uint64_t active_count_;
+    uint64_t sequence_;
+    
+    std::atomic<uint64_t> records_written_;
+    std::atomic<uint64_t> rotations_;       // Segments completed so far
+    std::atomic<bool> syncing_;
+    std::thread sync_thread_;
+    std::string last_error_;
+
+public:
+    TelemetryRecorder()
+        : joint_count_(0), imu_count_(0), record_bytes_(0), capacity_(0),
+          active_(0), active_count_(0), sequence_(0),
+          records_written_(0), rotations_(0), syncing_(false) {}
+    
+    ~TelemetryRecorder() { close(); }
+    
+    TelemetryRecorder(const TelemetryRecorder&) = delete;
+    TelemetryRecorder& operator=(const TelemetryRecorder&) = delete;
+    
+    static size_t recordBytes(size_t joints, size_t imus) {
+        const size_t bytes = sizeof(TelemetryRecordHeader)
+                           + 5 * joints * sizeof(double) + joints * sizeof(int64_t)
+                           + imus * sizeof(ImuData);
+        return (bytes + kCacheLineSize - 1) / kCacheLineSize * kCacheLineSize;
+    }
+    
+    // Create, size, map and prefault every segment. Not for the real-time
+    // thread. On failure returns false and lastError() says why.
+    bool open(const Options& options, size_t joints, size_t imus);
+    
+    // Stop the sync thread, flush everything and unmap. Not real-time safe.
+    void close();
+    
+    bool isOpen() const { return !segments_.empty(); }
+    
+    // Real-time safe: one record, copied straight from the SoA arrays
+    void record(uint64_t cycle, int64_t time_ns, const JointStateBank& joints,
+                const double* commands, ArrayView<ImuData> imus, double balance,
+                uint32_t violations, uint32_t estop_reasons) {
+        if (segments_.empty()) return;
+        if (active_count_ == capacity_) {
+            rotate();
+        }
+        Segment& segment = segments_[active_];
+        unsigned char* slot = segment.base + kHeaderBytes + active_count_ * record_bytes_;
+        
+        TelemetryRecordHeader* header = reinterpret_cast<TelemetryRecordHeader*>(slot);
+        header->cycle = cycle;
+        header->time_ns = time_ns;
+        header->balance = balance;
+        header->violations = violations;
+        header->estop_reasons = estop_reasons;
+        
+        const size_t n = std::min(joint_count_, joints.size());
+        static_assert(sizeof(int64_t) == sizeof(double), "timestamps share the column stride");
+        const size_t array_bytes = joint_count_ * sizeof(double);
+        unsigned char* out = slot + sizeof(TelemetryRecordHeader);
+        std::memcpy(out, joints.position(), n * sizeof(double));
+        std::memcpy(out + array_bytes, joints.velocity(), n * sizeof(double));
+        std::memcpy(out + 2 * array_bytes, joints.torque(), n * sizeof(double));
+        std::memcpy(out + 3 * array_bytes, joints.temperature(), n * sizeof(double));
+        std::memcpy(out + 4 * array_bytes, commands, n * sizeof(double));
+        std::memcpy(out + 5 * array_bytes, joints.timestampNs(), n * sizeof(int64_t));
+        std::memcpy(out + 6 * array_bytes, imus.data(),
+                    std::min(imu_count_, imus.size()) * sizeof(ImuData));
+        
+        // Publish after the payload, so a post-mortem reader never counts
+        // a half-written record
+        ++active_count_;
+        segment.header->record_count.store(active_count_, std::memory_order_release);
+        records_written_.fetch_add(1, std::memory_order_relaxed);
+    }
+    
+    uint64_t recordsWritten() const { return records_written_.load(std::memory_order_relaxed); }
+    uint64_t rotations() const { return rotations_.load(std::memory_order_relaxed); }
+    uint64_t recordsPerSegment() const { return capacity_; }
+    size_t recordBytes() const { return record_bytes_; }
+    size_t footprintBytes() const { return segments_.size() * options_.segment_bytes; }
+    const Options& options() const { return options_; }
+    const std::string& lastError() const { return last_error_; }
+
+private:
+    void rotate() {
+        rotations_.fetch_add(1, std::memory_order_release);
+        active_ = (active_ + 1) % segments_.size();
+        active_count_ = 0;
+        ++sequence_;
+        resetHeader(segments_[active_]);
+    }
+    
+    void resetHeader(Segment& segment) {
+        TelemetrySegmentHeader* header = segment.header;
+        header->record_count.store(0, std::memory_order_relaxed);
+        header->sequence = sequence_;
+    }
+    
+#ifdef __linux__
+    bool mapSegment(Segment& segment);
+    
+    // Write finished segments back in the background. Dirty pages of the
+    // active segment are left to the kernel's own writeback.
+    void syncLoop();
+#endif
+};
+
+// Reads the segment files written by TelemetryRecorder back as a single
+// stream of cycles, oldest first. Segments are put in order by their
+// sequence number, so a log that wrapped around reads correctly. Offline
+// use only: it allocates and does blocking file I/O.
+struct TelemetryFrame {
+    uint64_t cycle = 0;
+    int64_t time_ns = 0;
+    double balance = 0.0;
+    uint32_t violations = 0;
+    uint32_t estop_reasons = 0;
+    std::vector<JointState> joints;
+    std::vector<double> commands;
+    std::vector<ImuData> imus;
+};
+
+class TelemetryReader {
+private:
+    struct SegmentInfo {
+        std::string path;
+        uint64_t sequence;
+        uint64_t records;
+    };
+    
+    std::vector<SegmentInfo> segments_;     // In sequence order
+    size_t joint_count_;
+    size_t imu_count_;
+    size_t record_bytes_;
+    size_t header_bytes_;
+    
+    size_t segment_;                        // Read position
+    uint64_t record_;
+    std::ifstream file_;
+    std::vector<unsigned char> buffer_;
+    std::string last_error_;
+
+public:
+    TelemetryReader()
+        : joint_count_(0), imu_count_(0), record_bytes_(0), header_bytes_(0),
+          segment_(0), record_(0) {}
+    
+    // Scan the segments named by options; fails if none hold records or
+    // their layouts disagree
+    bool open(const TelemetryRecorder::Options& options);
+    
+    void rewind() {
+        segment_ = 0;
+        record_ = 0;
+        file_.close();
+    }
+    
+    // Next cycle in recording order; false at the end of the log
+    bool next(TelemetryFrame& frame);
+    
+    uint64_t recordCount() const {
+        uint64_t total = 0;
+        for (const auto& segment : segments_) total += segment.records;
+        return total;
+    }
+    
+    size_t jointCount() const { return joint_count_; }
+    size_t imuCount() const { return imu_count_; }
+    const std::string& lastError() const { return last_error_; }
+
+private:
+    void decode(const unsigned char* slot, TelemetryFrame& frame) const;
+};
+
+#endif  // HUMANOID_CONTROL_TELEMETRY_HPP
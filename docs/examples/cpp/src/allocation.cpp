@@ -0,0 +1,82 @@
+// Replacement global operator new/delete for the real-time allocation guard
+
+#include "humanoid_control/allocation.hpp"
+#include "humanoid_control/logging.hpp"
+
+#ifdef HUMANOID_ALLOC_GUARD
+
+#include <cstdio>
+#include <cstdlib>
+
+namespace {
+
+// Constant-initialised, so reading it never allocates or runs TLS init
+thread_local bool t_armed = false;
+
+std::atomic<uint64_t> g_violations(0);
+std::atomic<uint8_t> g_policy(AllocationGuard::Report);
+
+void checkAllocation(size_t bytes) {
+    if (!t_armed) return;
+    // Reporting may allocate (e.g. the logger's first use), so disarm
+    t_armed = false;
+    g_violations.fetch_add(1, std::memory_order_relaxed);
+    if (g_policy.load(std::memory_order_relaxed) == AllocationGuard::Abort) {
+        char message[96];
+        const int length = std::snprintf(message, sizeof(message),
+            "AllocationGuard: %zu-byte allocation on a guarded real-time thread\n", bytes);
+        if (length > 0) {
+            (void)!::write(STDERR_FILENO, message, static_cast<size_t>(length));
+        }
+        std::abort();
+    }
+    AsyncLogger::instance().log(LogEvent::RealtimeAllocation, static_cast<uint64_t>(bytes));
+    t_armed = true;
+}
+
+void* allocate(size_t bytes) {
+    checkAllocation(bytes);
+    if (void* p = std::malloc(bytes ? bytes : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void* allocateAligned(size_t bytes, std::align_val_t alignment) {
+    checkAllocation(bytes);
+    // posix_memalign rejects alignments below sizeof(void*)
+    const size_t align = std::max(static_cast<size_t>(alignment), sizeof(void*));
+    void* p = nullptr;
+    if (posix_memalign(&p, align, bytes ? bytes : 1) == 0) return p;
+    throw std::bad_alloc();
+}
+
+}  // namespace
+
+bool AllocationGuard::arm(bool armed) {
+    const bool previous = t_armed;
+    t_armed = armed;
+    return previous;
+}
+
+void AllocationGuard::setPolicy(Policy policy) {
+    g_policy.store(policy, std::memory_order_relaxed);
+}
+
+uint64_t AllocationGuard::violations() {
+    return g_violations.load(std::memory_order_relaxed);
+}
+
+void* operator new(size_t bytes) { return allocate(bytes); }
+void* operator new[](size_t bytes) { return allocate(bytes); }
+void* operator new(size_t bytes, std::align_val_t alignment) { return allocateAligned(bytes, alignment); }
+void* operator new[](size_t bytes, std::align_val_t alignment) { return allocateAligned(bytes, alignment); }
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+void operator delete[](void* p, size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, size_t, std::align_val_t) noexcept { std::free(p); }
+
+#endif  // HUMANOID_ALLOC_GUARD
@@ -0,0 +1,7 @@
+// Time utilities
+
+#include "humanoid_control/core.hpp"
+
+void Utils::sleep_for(double seconds) {
+    std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+}
@@ -0,0 +1,146 @@
+// Humanoid controller set-up and its pipeline stages
+
+#include "humanoid_control/humanoid_controller.hpp"
+
+std::vector<std::string> HumanoidController::defaultJointNames() {
+    return {
+        "left_hip", "left_knee", "left_ankle",
+        "right_hip", "right_knee", "right_ankle"
+    };
+}
+
+HumanoidController::HumanoidController(double frequency, const std::vector<std::string>& joint_names)
+    : ControlLoop(frequency),
+      joint_state_bank_(joint_names.size()),
+      pid_bank_(joint_state_bank_.size()),
+      pid_kernel_(joint_state_bank_.size()),
+      torque_commands_(joint_state_bank_.size()),
+      safety_limits_(joint_state_bank_.size()),
+      acquisition_(static_cast<int64_t>(1e9 / frequency),
+                   static_cast<int64_t>(1e9 / frequency)),
+      threaded_acquisition_(true),
+      safety_monitor_(joint_state_bank_, safety_limits_, estop_),
+      watchdog_(estop_, safety_monitor_, command_bus_,
+                SafetyWatchdog::Options::forRates(frequency, frequency)),
+      telemetry_enabled_(false) {
+    
+    if (joint_names.size() < 4) {
+        throw std::invalid_argument("HumanoidController: needs at least 4 joints");
+    }
+    for (size_t i = 0; i < joint_names.size(); ++i) {
+        joint_controllers_.emplace_back(joint_names[i], joint_state_bank_, pid_bank_,
+                                        safety_limits_, i);
+        joint_sensors_.emplace_back(joint_names[i] + "_pos_sensor");
+    }
+    
+    // Add IMU sensors
+    imu_sensors_.emplace_back("torso_imu");
+    imu_sensors_.emplace_back("head_imu");
+    
+    // Register with sensor fusion once, so the loop uses integer handles
+    for (const auto& name : joint_names) {
+        fusion_joints_.push_back(sensor_fusion_.registerJoint(name));
+    }
+    
+    for (auto& sensor : imu_sensors_) {
+        fusion_imus_.push_back(sensor_fusion_.registerImu(sensor.getName()));
+    }
+    
+    for (auto& sensor : joint_sensors_) {
+        acquisition_.addJointSensor(&sensor);
+    }
+    
+    for (auto& sensor : imu_sensors_) {
+        acquisition_.addImuSensor(&sensor);
+    }
+    
+    // Attach actuators to the command bus
+    for (auto& controller : joint_controllers_) {
+        controller.attachBus(command_bus_);
+    }
+    
+    // Register with safety monitor
+    for (auto& controller : joint_controllers_) {
+        safety_monitor_.addController(&controller);
+    }
+    
+    for (auto& sensor : joint_sensors_) {
+        safety_monitor_.addJointSensor(&sensor);
+    }
+    
+    for (auto& sensor : imu_sensors_) {
+        safety_monitor_.addImuSensor(&sensor);
+    }
+}
+
+bool HumanoidController::beginReplay() {
+    for (auto& controller : joint_controllers_) {
+        if (!controller.initialize()) {
+            return false;
+        }
+    }
+    is_running_ = true;
+    return true;
+}
+
+void HumanoidController::openTelemetry() {
+    AsyncLogger& log = AsyncLogger::instance();
+    if (!telemetry_.open(telemetry_options_, joint_state_bank_.size(), imu_sensors_.size())) {
+        log.log(LogEvent::TelemetryOpenFailed, telemetry_.lastError().c_str());
+        return;
+    }
+    log.log(LogEvent::TelemetryOpened, telemetry_.recordsPerSegment(), telemetry_.recordBytes(),
+            telemetry_options_.segment_count, telemetry_options_.directory.c_str());
+}
+
+void HumanoidController::startRun(bool simulated) {
+    if (telemetry_enabled_) {
+        openTelemetry();
+    }
+    if (threaded_acquisition_ && !simulated) {
+        acquisition_.start();
+    }
+}
+
+void HumanoidController::finishRun() {
+    acquisition_.stop();
+    if (telemetry_.isOpen()) {
+        AsyncLogger::instance().log(LogEvent::TelemetryClosed, telemetry_.recordsWritten(),
+                                    telemetry_.rotations());
+        telemetry_.close();
+    }
+}
+
+void HumanoidController::configureStages() {
+    using Stage = CycleInstrumentation::Stage;
+    
+    // A tick runs its tasks in stage order: safety checks the samples read
+    // in the same tick, and telemetry records the commands just computed
+    scheduler_.addTask(stageTask("imu", rates_.imu, Stage::SensorRead),
+                       [this](const Tick& tick) { imuStage(tick); });
+    scheduler_.addTask(stageTask("joints", rates_.joints, Stage::SensorRead),
+                       [this](const Tick& tick) { jointStage(tick); });
+    scheduler_.addTask(stageTask("temperature", rates_.temperature, Stage::SensorRead),
+                       [this](const Tick& tick) { temperatureStage(tick); });
+    scheduler_.addTask(stageTask("balance", rates_.balance, Stage::Fusion),
+                       [this](const Tick&) { sensor_fusion_.updateBalance(); });
+    scheduler_.addTask(controlTask("control", rates_.control_budget_ns, Stage::Control),
+                       [this](const Tick& tick) { controlStage(tick); });
+    scheduler_.addTask(stageTask("safety", rates_.safety, Stage::Safety),
+                       [this](const Tick& tick) {
+                           safety_monitor_.checkSafety(tick.wake_ns, cycle_arena_);
+                       });
+    scheduler_.addTask(controlTask("telemetry", rates_.telemetry_budget_ns, Stage::Telemetry),
+                       [this](const Tick& tick) { telemetryStage(tick); });
+    
+    acquisition_.setPeriods(periodNs(rates_.joints.rate_hz), periodNs(rates_.imu.rate_hz),
+                            periodNs(rates_.temperature.rate_hz));
+}
+
+void HumanoidController::primeSensors(int64_t now_ns) {
+    acquisition_.pollTemperatures(now_ns);
+    acquisition_.pollJoints(now_ns);
+    acquisition_.pollImus(now_ns);
+    drainSensors();
+    sensor_fusion_.updateBalance();
+}
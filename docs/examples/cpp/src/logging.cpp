@@ -0,0 +1,110 @@
+// Asynchronous logger: the writer thread and record formatting
+
+#include "humanoid_control/logging.hpp"
+
+AsyncLogger::AsyncLogger(std::ostream& out)
+    : flush_requests_(0), flushes_done_(0), running_(true), enabled_(true), out_(&out) {
+    for (auto& leased : leased_) {
+        leased.store(false, std::memory_order_relaxed);
+    }
+    writer_ = std::thread([this] { writerLoop(); });
+}
+
+AsyncLogger::~AsyncLogger() {
+    running_ = false;
+    if (writer_.joinable()) {
+        writer_.join();
+    }
+    drainAll();
+    out_->flush();
+}
+
+AsyncLogger& AsyncLogger::instance() {
+    static AsyncLogger logger(std::cout);
+    return logger;
+}
+
+void AsyncLogger::flush() {
+    const uint64_t ticket = flush_requests_.fetch_add(1, std::memory_order_acq_rel) + 1;
+    while (flushes_done_.load(std::memory_order_acquire) < ticket) {
+        Utils::sleep_for(0.0005);
+    }
+}
+
+void AsyncLogger::writerLoop() {
+    while (running_.load(std::memory_order_relaxed)) {
+        const uint64_t requested = flush_requests_.load(std::memory_order_acquire);
+        const size_t written = drainAll();
+        if (requested > flushes_done_.load(std::memory_order_relaxed)) {
+            out_->flush();
+            flushes_done_.store(requested, std::memory_order_release);
+        }
+        if (written == 0) {
+            Utils::sleep_for(0.001);
+        }
+    }
+    flushes_done_.store(UINT64_MAX, std::memory_order_release);
+}
+
+size_t AsyncLogger::drainAll() {
+    std::lock_guard<std::mutex> lock(writer_mutex_);
+    auto write = [this](const LogRecord& record) { format(record); };
+    size_t written = 0;
+    for (Ring& ring : rings_) {
+        written += ring.drain(write);
+    }
+    return written + overflow_.drain(write);
+}
+
+void AsyncLogger::format(const LogRecord& record) {
+    std::ostream& out = *out_;
+    const char* text = kLogFormats[static_cast<size_t>(record.event)];
+    size_t next = 0;
+    while (*text) {
+        if (text[0] != '{') {
+            out << *text++;
+            continue;
+        }
+        int precision = -1;
+        const char* end = text + 1;
+        if (*end == '.') {
+            precision = 0;
+            for (++end; *end >= '0' && *end <= '9'; ++end) {
+                precision = precision * 10 + (*end - '0');
+            }
+        }
+        if (*end != '}' || next >= record.arg_count) {
+            out << *text++;
+            continue;
+        }
+        writeArg(out, record, record.args[next++], precision);
+        text = end + 1;
+    }
+    out << '\n';
+}
+
+void AsyncLogger::writeArg(std::ostream& out, const LogRecord& record, const LogArg& arg,
+                           int precision) {
+    switch (arg.type) {
+    case LogArg::Int:
+        out << arg.i;
+        break;
+    case LogArg::Double:
+        if (precision >= 0) {
+            const std::ios_base::fmtflags flags = out.flags();
+            const std::streamsize old_precision = out.precision(precision);
+            out << std::fixed << arg.d;
+            out.flags(flags);
+            out.precision(old_precision);
+        } else {
+            out << arg.d;
+        }
+        break;
+    case LogArg::String:
+        // Bounded: a string logged after the buffer filled up is empty
+        out.write(record.text + arg.text,
+                  static_cast<std::streamsize>(strnlen(record.text + arg.text,
+                                                       LogRecord::kTextBytes - arg.text)));
+        break;
+    }
+}
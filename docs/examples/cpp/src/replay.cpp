@@ -0,0 +1,60 @@
+// Deterministic replay of recorded telemetry
+
+#include "humanoid_control/replay.hpp"
+
+ReplayEngine::Result ReplayEngine::run(HumanoidController& controller, TelemetryReader& log) {
+    Result result;
+    if (log.jointCount() != controller.jointCount() || log.imuCount() != controller.imuCount()) {
+        result.error = "log has " + std::to_string(log.jointCount()) + " joints and " +
+                       std::to_string(log.imuCount()) + " IMUs, controller has " +
+                       std::to_string(controller.jointCount()) + " and " +
+                       std::to_string(controller.imuCount());
+        return result;
+    }
+    if (!controller.beginReplay()) {
+        result.error = "controller failed to initialize";
+        return result;
+    }
+    
+    uint64_t hash = 14695981039346656037ull;
+    auto mix = [&hash](double value) {
+        uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        for (int b = 0; b < 8; ++b) {
+            hash ^= (bits >> (8 * b)) & 0xff;
+            hash *= 1099511628211ull;
+        }
+    };
+    
+    TelemetryFrame frame;
+    int64_t first_ns = 0;
+    int64_t last_ns = 0;
+    const int64_t wall_start = CycleClock::steadyNowNs();
+    log.rewind();
+    while (log.next(frame)) {
+        if (result.cycles == 0) first_ns = frame.time_ns;
+        last_ns = frame.time_ns;
+        if (!controller.replayCycle(frame)) {
+            result.stopped_at_cycle = static_cast<int64_t>(frame.cycle);
+            break;
+        }
+        ++result.cycles;
+        
+        const double* commands = controller.torqueCommands();
+        for (size_t j = 0; j < frame.commands.size(); ++j) {
+            mix(commands[j]);
+            result.max_command_error = std::max(result.max_command_error,
+                                                std::fabs(commands[j] - frame.commands[j]));
+        }
+        const double balance = controller.balanceEstimate();
+        mix(balance);
+        result.max_balance_error = std::max(result.max_balance_error,
+                                            std::fabs(balance - frame.balance));
+    }
+    result.wall_seconds = (CycleClock::steadyNowNs() - wall_start) * 1e-9;
+    result.recorded_seconds = (last_ns - first_ns) * 1e-9;
+    result.output_hash = hash;
+    result.error = log.lastError();
+    result.ok = result.error.empty();
+    return result;
+}
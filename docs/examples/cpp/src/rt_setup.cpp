@@ -0,0 +1,117 @@
+// Real-time thread configuration and the wakeup latency probe
+
+#include "humanoid_control/rt_setup.hpp"
+
+RtReport RtSetup::apply(const RtConfig& config) {
+    AsyncLogger& log = AsyncLogger::instance();
+    RtReport report;
+    if (!config.enabled) {
+        return report;
+    }
+#ifdef __linux__
+    sched_param param{};
+    param.sched_priority = config.priority;
+    int rc = pthread_setschedparam(pthread_self(), config.policy, &param);
+    report.scheduler_set = (rc == 0);
+    if (rc != 0) {
+        log.log(LogEvent::RtSchedulerFailed, config.policy, config.priority, std::strerror(rc));
+    }
+    
+    report.cpu = config.cpu >= 0 ? config.cpu : isolatedCpu(config.isolated_index);
+    if (report.cpu >= 0) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(report.cpu, &set);
+        rc = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+        report.affinity_set = (rc == 0);
+        if (rc != 0) {
+            log.log(LogEvent::RtAffinityFailed, report.cpu, std::strerror(rc));
+        }
+    } else {
+        log.log(LogEvent::RtNoIsolatedCpu, config.isolated_index);
+    }
+    
+    if (config.lock_memory) {
+        report.memory_locked = (mlockall(MCL_CURRENT | MCL_FUTURE) == 0);
+        if (!report.memory_locked) {
+            log.log(LogEvent::RtLockFailed, std::strerror(errno));
+        }
+    }
+    
+    report.heap_prefaulted = prefaultHeap(config.heap_prefault_bytes);
+#endif
+    report.stack_prefaulted = prefaultStack();
+    
+    if (config.latency_probe_samples > 0) {
+        probeWakeLatency(config, report);
+    }
+    return report;
+}
+
+void RtSetup::log(const RtReport& report) {
+    AsyncLogger& log = AsyncLogger::instance();
+    log.log(LogEvent::RtConfigured, report.scheduler_set ? "ok" : "default",
+            report.affinity_set ? "pinned" : "none", report.cpu,
+            report.memory_locked ? "ok" : "no", report.stack_prefaulted ? "ok" : "no",
+            report.heap_prefaulted ? "ok" : "no");
+    log.log(LogEvent::RtWakeLatency, report.wake_p50_ns / 1000.0, report.wake_p99_ns / 1000.0,
+            report.wake_max_ns / 1000.0);
+}
+
+bool RtSetup::prefaultStack() {
+    volatile unsigned char stack[kStackPrefaultBytes];
+    for (size_t i = 0; i < kStackPrefaultBytes; i += 4096) {
+        stack[i] = 0;
+    }
+    return stack[0] == 0;
+}
+
+#ifdef __linux__
+bool RtSetup::prefaultHeap(size_t bytes) {
+    if (bytes == 0) return false;
+    mallopt(M_TRIM_THRESHOLD, -1);
+    mallopt(M_MMAP_MAX, 0);
+    unsigned char* block = static_cast<unsigned char*>(malloc(bytes));
+    if (!block) return false;
+    for (size_t i = 0; i < bytes; i += 4096) {
+        block[i] = 0;
+    }
+    free(block);
+    return true;
+}
+
+int RtSetup::isolatedCpu(int index) {
+    std::ifstream isolated("/sys/devices/system/cpu/isolated");
+    int first = -1;
+    while (isolated >> first) {
+        int last = first;
+        if (isolated.peek() == '-') {
+            isolated.get();
+            isolated >> last;
+        }
+        if (index <= last - first) {
+            return first + index;
+        }
+        index -= last - first + 1;
+        if (isolated.peek() == ',') {
+            isolated.get();
+        }
+    }
+    return -1;
+}
+#endif
+
+void RtSetup::probeWakeLatency(const RtConfig& config, RtReport& report) {
+    std::vector<int64_t> lateness;
+    lateness.reserve(config.latency_probe_samples);
+    PeriodicExecutor probe(config.latency_probe_period_ns);
+    probe.run([&](const PeriodicExecutor::TickInfo& tick) {
+        lateness.push_back(tick.wake_ns - tick.release_ns);
+        return lateness.size() < static_cast<size_t>(config.latency_probe_samples);
+    });
+    
+    std::sort(lateness.begin(), lateness.end());
+    report.wake_p50_ns = lateness[lateness.size() / 2];
+    report.wake_p99_ns = lateness[lateness.size() * 99 / 100];
+    report.wake_max_ns = lateness.back();
+}
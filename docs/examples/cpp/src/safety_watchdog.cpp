@@ -0,0 +1,45 @@
+// Safety watchdog thread
+
+#include "humanoid_control/safety_watchdog.hpp"
+
+void SafetyWatchdog::watchLoop() {
+    // RT setup (mlockall, prefaulting, affinity) can take a while; a stop()
+    // that arrives meanwhile is kept by the executor and ends the loop here
+    if (executor_.stopRequested()) return;
+    rt_report_ = RtSetup::apply(options_.rt);
+    if (executor_.stopRequested()) return;
+    
+    uint64_t last_beat = heartbeat_.load(std::memory_order_acquire);
+    int64_t last_beat_ns = PeriodicExecutor::monotonicNowNs();
+    bool halted = false;
+    
+    executor_.run([&](const PeriodicExecutor::TickInfo& tick) {
+        const uint64_t beat = heartbeat_.load(std::memory_order_acquire);
+        if (beat != last_beat) {
+            last_beat = beat;
+            last_beat_ns = tick.wake_ns;
+        }
+        const int64_t gap = tick.wake_ns - last_beat_ns;
+        if (gap > max_gap_ns_.load(std::memory_order_relaxed)) {
+            max_gap_ns_.store(gap, std::memory_order_relaxed);
+        }
+        
+        if (armed_.load(std::memory_order_relaxed)) {
+            if (gap > options_.heartbeat_timeout_ns) {
+                estop_->trigger(EmergencyStop::HeartbeatTimeout, tick.wake_ns);
+            }
+            if (monitor_->violationMask() != 0) {
+                estop_->trigger(EmergencyStop::LimitViolation, tick.wake_ns);
+            }
+        }
+        
+        // Whoever tripped it, make sure the actuators get zeroed
+        if (!halted && estop_->isActive()) {
+            command_bus_->halt();
+            reaction_ns_.store(PeriodicExecutor::monotonicNowNs() - estop_->tripTimeNs(),
+                               std::memory_order_relaxed);
+            halted = true;
+        }
+        return true;
+    });
+}
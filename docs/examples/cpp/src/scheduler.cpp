@@ -0,0 +1,103 @@
+// Rate-monotonic scheduler set-up and reporting
+
+#include "humanoid_control/scheduler.hpp"
+
+size_t RateMonotonicScheduler::addTask(const TaskSpec& spec, TaskFn fn) {
+    if (spec.period_ns <= 0) {
+        throw std::invalid_argument(std::string("RateMonotonicScheduler: task ") + spec.name +
+                                    " needs a positive period");
+    }
+    if (spec.phase_ns < 0 || spec.phase_ns >= spec.period_ns) {
+        throw std::invalid_argument(std::string("RateMonotonicScheduler: task ") + spec.name +
+                                    " phase must be in [0, period)");
+    }
+    if (spec.budget_ns < 0 || spec.budget_ns > spec.period_ns) {
+        throw std::invalid_argument(std::string("RateMonotonicScheduler: task ") + spec.name +
+                                    " budget must be in [0, period]");
+    }
+    if (spec.stage < 0 || spec.stage > CycleInstrumentation::kStageCount) {
+        throw std::invalid_argument(std::string("RateMonotonicScheduler: task ") + spec.name +
+                                    " has no such stage");
+    }
+    
+    // Periods with a tiny common divisor (300 and 333 Hz give 1ns) would
+    // tick the executor almost continuously
+    const int64_t base = std::gcd(std::gcd(base_ns_, spec.period_ns), spec.phase_ns);
+    if (base < kMinBaseTickNs) {
+        throw std::invalid_argument(std::string("RateMonotonicScheduler: task ") + spec.name +
+                                    " brings the base tick to " + std::to_string(base) +
+                                    "ns, below the " + std::to_string(kMinBaseTickNs) +
+                                    "ns minimum; use periods that divide each other");
+    }
+    
+    tasks_.emplace_back(spec, std::move(fn));
+    base_ns_ = base;
+    
+    // Stable, so equal periods keep their registration order
+    order_.push_back(&tasks_.back());
+    std::stable_sort(order_.begin(), order_.end(), [](const Task* a, const Task* b) {
+        if (a->spec.stage != b->spec.stage) return a->spec.stage < b->spec.stage;
+        return a->spec.period_ns < b->spec.period_ns;
+    });
+    reset();
+    return tasks_.size() - 1;
+}
+
+void RateMonotonicScheduler::clear() {
+    order_.clear();
+    tasks_.clear();
+    base_ns_ = 0;
+    started_ = false;
+}
+
+bool RateMonotonicScheduler::isHarmonic() const {
+    std::vector<int64_t> periods;
+    for (const Task& task : tasks_) {
+        periods.push_back(task.spec.period_ns);
+    }
+    std::sort(periods.begin(), periods.end());
+    for (size_t i = 1; i < periods.size(); ++i) {
+        if (periods[i] % periods[i - 1] != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+double RateMonotonicScheduler::utilization() const {
+    double total = 0.0;
+    for (const Task& task : tasks_) {
+        total += static_cast<double>(task.spec.budget_ns) / task.spec.period_ns;
+    }
+    return total;
+}
+
+double RateMonotonicScheduler::utilizationBound() const {
+    if (isHarmonic()) {
+        return 1.0;
+    }
+    const double n = static_cast<double>(tasks_.size());
+    return n * (std::pow(2.0, 1.0 / n) - 1.0);
+}
+
+void RateMonotonicScheduler::printSummary(std::ostream& out) const {
+    LatencyHistogram::Snapshot snap;
+    out << "Task\t\trate(Hz)\tbudget(us)\truns\tp50(us)\tp99(us)\tmax(us)\tover budget\tmissed\n";
+    for (const Task* task : order_) {
+        task->execution_ns.snapshot(snap);
+        out << std::fixed << std::setprecision(2)
+            << task->spec.name << "\t"
+            << (std::strlen(task->spec.name) < 8 ? "\t" : "")
+            << 1e9 / task->spec.period_ns << "\t\t"
+            << task->spec.budget_ns / 1000.0 << "\t\t"
+            << task->runs << "\t"
+            << snap.percentile(0.50) / 1000.0 << "\t"
+            << snap.percentile(0.99) / 1000.0 << "\t"
+            << snap.max / 1000.0 << "\t"
+            << task->budget_overruns << "\t\t"
+            << task->missed_releases << "\n";
+    }
+    out << "Base tick: " << base_ns_ / 1000.0 << "us, utilization: " << utilization()
+        << " of " << utilizationBound() << (isHarmonic() ? " (harmonic)" : " (Liu-Layland)")
+        << (isSchedulable() ? "" : ", NOT SCHEDULABLE") << "\n";
+}
@@ -0,0 +1,100 @@
+// Monte Carlo sweep runner
+
+#include "humanoid_control/sweep.hpp"
+
+SweepSummary SweepRunner::run(const std::vector<SweepParameters>& grid, const SweepOptions& options) {
+    const size_t threads = options.threads > 0
+        ? options.threads : std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    WorkStealingPool pool(std::min(threads, std::max<size_t>(grid.size(), 1)));
+    
+    // Each run writes only its own slot
+    SweepSummary summary;
+    summary.run_metrics.resize(grid.size());
+    const int64_t start = CycleClock::steadyNowNs();
+    pool.run(grid.size(), [&](size_t, size_t run) {
+        // A sweep would otherwise log every controller's start-up
+        AsyncLogger::ThreadMute mute;
+        summary.run_metrics[run] = runOne(grid[run], options, run);
+    });
+    
+    // Floating-point sums depend on order, so fold in run order
+    for (const auto& metrics : summary.run_metrics) {
+        accumulate(summary, metrics);
+    }
+    summary.steals = pool.steals();
+    summary.wall_seconds = (CycleClock::steadyNowNs() - start) * 1e-9;
+    return summary;
+}
+
+SweepRunMetrics SweepRunner::runOne(const SweepParameters& parameters, const SweepOptions& options,
+                                    size_t run) {
+    SweepRunMetrics metrics;
+    metrics.run = run;
+    metrics.seed = runSeed(options.seed, run);
+    metrics.parameters = parameters;
+    
+    HumanoidController controller(options.frequency);
+    controller.enableVirtualTime();
+    controller.setDuration(options.duration);
+    controller.setGains(parameters.kp, parameters.ki, parameters.kd);
+    controller.setNoiseLevel(parameters.noise_sigma);
+    controller.setVelocityLimit(parameters.velocity_limit);
+    controller.setNoiseSeed(metrics.seed);
+    
+    const size_t joints = controller.jointCount();
+    for (size_t j = 0; j < joints; ++j) {
+        controller.setTargetPosition(j, options.target_position);
+    }
+    if (!controller.beginSimulation()) {
+        return metrics;
+    }
+    
+    std::vector<double> position(joints, 0.0);
+    std::vector<double> velocity(joints, 0.0);
+    const double dt = 1.0 / options.frequency;
+    const int64_t period_ns = static_cast<int64_t>(1e9 / options.frequency);
+    const double* targets = controller.jointTargets();
+    double squared_error = 0.0;
+    
+    while (true) {
+        // Plant: integrate the torque the actuators apply right now
+        // (semi-implicit Euler), then let the sensors read the result
+        for (size_t j = 0; j < joints; ++j) {
+            const double torque = controller.appliedTorque(j);
+            velocity[j] += (torque - options.damping * velocity[j]) / options.inertia * dt;
+            position[j] += velocity[j] * dt;
+            
+            JointSensor& sensor = controller.jointSensor(j);
+            JointState state = sensor.getState();
+            state.position = position[j];
+            state.velocity = velocity[j];
+            state.torque = torque;
+            sensor.setState(state);
+        }
+        
+        const int64_t compute_start = CycleClock::steadyNowNs();
+        const bool running = controller.stepSimulation();
+        if (CycleClock::steadyNowNs() - compute_start > period_ns) {
+            metrics.budget_overruns++;
+        }
+        if (!running) break;
+        metrics.cycles++;
+        
+        for (size_t j = 0; j < joints; ++j) {
+            const double error = std::fabs(targets[j] - position[j]);
+            squared_error += error * error;
+            metrics.max_tracking_error = std::max(metrics.max_tracking_error, error);
+        }
+    }
+    
+    const EmergencyStop& estop = controller.emergencyStop();
+    metrics.tripped = estop.isActive();
+    if (metrics.tripped) {
+        metrics.trip_time = metrics.cycles * dt;
+    }
+    if (metrics.cycles > 0) {
+        metrics.rms_tracking_error = std::sqrt(squared_error / (metrics.cycles * joints));
+    }
+    metrics.score = metrics.rms_tracking_error + (metrics.tripped ? options.trip_penalty : 0.0);
+    return metrics;
+}
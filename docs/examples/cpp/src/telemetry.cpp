@@ -0,0 +1,215 @@
+// Telemetry segment files: creation, mapping, background sync and reading back
+
+#include "humanoid_control/telemetry.hpp"
+
+bool TelemetryRecorder::open(const Options& options, size_t joints, size_t imus) {
+    close();
+    options_ = options;
+    joint_count_ = joints;
+    imu_count_ = imus;
+    record_bytes_ = recordBytes(joints, imus);
+    if (options.segment_count == 0 || options.segment_bytes < kHeaderBytes + record_bytes_) {
+        last_error_ = "segment too small for one record";
+        return false;
+    }
+    capacity_ = (options.segment_bytes - kHeaderBytes) / record_bytes_;
+#ifdef __linux__
+    segments_.resize(options.segment_count);
+    for (size_t i = 0; i < segments_.size(); ++i) {
+        Segment& segment = segments_[i];
+        segment.path = options.directory + "/" + options.prefix + "_" + std::to_string(i) + ".bin";
+        if (!mapSegment(segment)) {
+            close();
+            return false;
+        }
+    }
+    active_ = 0;
+    active_count_ = 0;
+    sequence_ = 0;
+    resetHeader(segments_[0]);
+    records_written_ = 0;
+    rotations_ = 0;
+    syncing_ = true;
+    sync_thread_ = std::thread([this] { syncLoop(); });
+    return true;
+#else
+    last_error_ = "memory-mapped telemetry needs Linux";
+    return false;
+#endif
+}
+
+void TelemetryRecorder::close() {
+    syncing_ = false;
+    if (sync_thread_.joinable()) {
+        sync_thread_.join();
+    }
+#ifdef __linux__
+    for (auto& segment : segments_) {
+        if (segment.base) {
+            msync(segment.base, options_.segment_bytes, MS_SYNC);
+            munmap(segment.base, options_.segment_bytes);
+        }
+    }
+#endif
+    segments_.clear();
+}
+
+#ifdef __linux__
+bool TelemetryRecorder::mapSegment(Segment& segment) {
+    const int fd = ::open(segment.path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        last_error_ = segment.path + ": " + std::strerror(errno);
+        return false;
+    }
+    // Allocate the blocks now so the loop never extends the file
+    int rc = posix_fallocate(fd, 0, static_cast<off_t>(options_.segment_bytes));
+    if (rc != 0 && ftruncate(fd, static_cast<off_t>(options_.segment_bytes)) != 0) {
+        last_error_ = segment.path + ": " + std::strerror(errno);
+        ::close(fd);
+        return false;
+    }
+    void* base = mmap(nullptr, options_.segment_bytes, PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_POPULATE, fd, 0);
+    ::close(fd);
+    if (base == MAP_FAILED) {
+        last_error_ = segment.path + ": mmap: " + std::strerror(errno);
+        return false;
+    }
+    segment.base = static_cast<unsigned char*>(base);
+    
+    // Write every page once so the first pass through the loop does
+    // not take write faults
+    for (size_t offset = 0; offset < options_.segment_bytes; offset += 4096) {
+        segment.base[offset] = 0;
+    }
+    
+    TelemetrySegmentHeader* header = new (segment.base) TelemetrySegmentHeader;
+    std::memcpy(header->magic, "HUMTLM1", 8);
+    header->version = TelemetrySegmentHeader::kVersion;
+    header->header_bytes = static_cast<uint32_t>(kHeaderBytes);
+    header->record_bytes = static_cast<uint32_t>(record_bytes_);
+    header->joint_count = static_cast<uint32_t>(joint_count_);
+    header->imu_count = static_cast<uint32_t>(imu_count_);
+    header->reserved = 0;
+    header->sequence = 0;
+    header->capacity = capacity_;
+    header->record_count.store(0, std::memory_order_relaxed);
+    segment.header = header;
+    return true;
+}
+
+void TelemetryRecorder::syncLoop() {
+    uint64_t synced = 0;
+    while (syncing_.load(std::memory_order_relaxed)) {
+        const uint64_t completed = rotations_.load(std::memory_order_acquire);
+        // Only the most recent segments still hold their data
+        if (completed - synced > segments_.size() - 1) {
+            synced = completed - (segments_.size() - 1);
+        }
+        for (; synced < completed; ++synced) {
+            msync(segments_[synced % segments_.size()].base, options_.segment_bytes, MS_ASYNC);
+        }
+        std::this_thread::sleep_for(std::chrono::nanoseconds(options_.sync_period_ns));
+    }
+}
+#endif
+
+bool TelemetryReader::open(const TelemetryRecorder::Options& options) {
+    segments_.clear();
+    last_error_.clear();
+    for (size_t i = 0; i < options.segment_count; ++i) {
+        const std::string path = options.directory + "/" + options.prefix + "_" + std::to_string(i) + ".bin";
+        std::ifstream in(path, std::ios::binary);
+        if (!in) continue;
+        
+        TelemetrySegmentHeader header;
+        in.read(reinterpret_cast<char*>(&header), sizeof(header));
+        if (!in || std::memcmp(header.magic, "HUMTLM1", 8) != 0 ||
+            header.version != TelemetrySegmentHeader::kVersion) {
+            last_error_ = path + ": not a telemetry segment";
+            return false;
+        }
+        const uint64_t records = header.record_count.load(std::memory_order_relaxed);
+        if (records == 0) continue;
+        
+        if (segments_.empty()) {
+            joint_count_ = header.joint_count;
+            imu_count_ = header.imu_count;
+            record_bytes_ = header.record_bytes;
+            header_bytes_ = header.header_bytes;
+        } else if (header.joint_count != joint_count_ || header.imu_count != imu_count_ ||
+                   header.record_bytes != record_bytes_) {
+            last_error_ = path + ": layout differs from the other segments";
+            return false;
+        }
+        segments_.push_back({path, header.sequence, std::min(records, header.capacity)});
+    }
+    if (segments_.empty()) {
+        last_error_ = "no telemetry records under " + options.directory + "/" + options.prefix;
+        return false;
+    }
+    std::sort(segments_.begin(), segments_.end(),
+              [](const SegmentInfo& a, const SegmentInfo& b) { return a.sequence < b.sequence; });
+    buffer_.resize(record_bytes_);
+    rewind();
+    return true;
+}
+
+bool TelemetryReader::next(TelemetryFrame& frame) {
+    while (segment_ < segments_.size() && record_ == segments_[segment_].records) {
+        ++segment_;
+        record_ = 0;
+        file_.close();
+    }
+    if (segment_ >= segments_.size()) return false;
+    
+    if (!file_.is_open()) {
+        file_.open(segments_[segment_].path, std::ios::binary);
+        file_.seekg(static_cast<std::streamoff>(header_bytes_));
+    }
+    file_.read(reinterpret_cast<char*>(buffer_.data()), static_cast<std::streamsize>(record_bytes_));
+    if (!file_) {
+        last_error_ = segments_[segment_].path + ": truncated";
+        return false;
+    }
+    ++record_;
+    decode(buffer_.data(), frame);
+    return true;
+}
+
+void TelemetryReader::decode(const unsigned char* slot, TelemetryFrame& frame) const {
+    TelemetryRecordHeader header;
+    std::memcpy(&header, slot, sizeof(header));
+    frame.cycle = header.cycle;
+    frame.time_ns = header.time_ns;
+    frame.balance = header.balance;
+    frame.violations = header.violations;
+    frame.estop_reasons = header.estop_reasons;
+    
+    const size_t n = joint_count_;
+    const unsigned char* in = slot + sizeof(TelemetryRecordHeader);
+    auto column = [&](size_t array, size_t j) {
+        double value;
+        std::memcpy(&value, in + (array * n + j) * sizeof(double), sizeof(double));
+        return value;
+    };
+    auto timestamp = [&](size_t j) {
+        int64_t value;
+        std::memcpy(&value, in + (5 * n + j) * sizeof(double), sizeof(int64_t));
+        return value;
+    };
+    frame.joints.resize(n);
+    frame.commands.resize(n);
+    for (size_t j = 0; j < n; ++j) {
+        JointState& state = frame.joints[j];
+        state.position = column(0, j);
+        state.velocity = column(1, j);
+        state.torque = column(2, j);
+        state.temperature = column(3, j);
+        state.timestamp_ns = timestamp(j);
+        frame.commands[j] = column(4, j);
+    }
+    frame.imus.resize(imu_count_);
+    std::memcpy(static_cast<void*>(frame.imus.data()), in + 6 * n * sizeof(double),
+                imu_count_ * sizeof(ImuData));
+}
@@ -0,0 +1,51 @@
+// SensorAcquisition: threads start and stop cleanly, however short the run
+
+#include "humanoid_control/acquisition.hpp"
+
+#include <gtest/gtest.h>
+
+#include <future>
+
+namespace {
+
+constexpr auto kHangTimeout = std::chrono::seconds(5);
+
+}  // namespace
+
+TEST(AcquisitionTest, StopRightAfterStartReturns) {
+    JointSensor joint("hip_pos_sensor");
+    ImuSensor imu("torso_imu");
+    SensorAcquisition acquisition(1000000, 500000);
+    acquisition.addJointSensor(&joint);
+    acquisition.addImuSensor(&imu);
+    
+    // Both threads are usually still starting up when stop() arrives
+    for (int attempt = 0; attempt < 50; ++attempt) {
+        acquisition.start();
+        ASSERT_TRUE(acquisition.isThreaded());
+        auto stopped = std::async(std::launch::async, [&] { acquisition.stop(); });
+        ASSERT_EQ(stopped.wait_for(kHangTimeout), std::future_status::ready)
+            << "stop() hung on attempt " << attempt;
+        EXPECT_FALSE(acquisition.isThreaded());
+    }
+}
+
+TEST(AcquisitionTest, RestartedThreadsProduceSamples) {
+    JointSensor joint("hip_pos_sensor");
+    ImuSensor imu("torso_imu");
+    SensorAcquisition acquisition(1000000, 500000);
+    acquisition.addJointSensor(&joint);
+    acquisition.addImuSensor(&imu);
+    
+    acquisition.start();
+    acquisition.stop();
+    acquisition.drainJoints([](const JointSample&) {});
+    acquisition.drainImus([](const ImuSample&) {});
+    
+    // A stop() from the first run must not end the second one early
+    acquisition.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    acquisition.stop();
+    EXPECT_GT(acquisition.drainJoints([](const JointSample&) {}), 0u);
+    EXPECT_GT(acquisition.drainImus([](const ImuSample&) {}), 0u);
+}
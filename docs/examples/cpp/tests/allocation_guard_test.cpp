@@ -0,0 +1,90 @@
+// AllocationGuard: heap use inside a guarded scope is caught. Built against
+// a copy of the library compiled with HUMANOID_ALLOC_GUARD.
+
+#include "humanoid_control/humanoid_controller.hpp"
+
+#include <gtest/gtest.h>
+
+static_assert(AllocationGuard::kEnabled, "this suite needs HUMANOID_ALLOC_GUARD");
+
+namespace {
+
+// A volatile sink keeps the compiler from eliding the new/delete pair
+int* volatile g_sink = nullptr;
+
+void allocateOnce() {
+    g_sink = new int(1);
+    delete g_sink;
+}
+
+}  // namespace
+
+TEST(AllocationGuardTest, ReportsAllocationsOnlyInsideAGuardedScope) {
+    AllocationGuard::setPolicy(AllocationGuard::Report);
+    const uint64_t before = AllocationGuard::violations();
+    allocateOnce();
+    EXPECT_EQ(AllocationGuard::violations(), before);
+    {
+        AllocationGuard::Scope guarded;
+        allocateOnce();
+        {
+            AllocationGuard::Scope nested;
+        }
+        allocateOnce();     // Still armed after the nested scope
+    }
+    EXPECT_EQ(AllocationGuard::violations(), before + 2);
+    allocateOnce();
+    EXPECT_EQ(AllocationGuard::violations(), before + 2);
+}
+
+TEST(AllocationGuardTest, OtherThreadsAreNotGuarded) {
+    AllocationGuard::setPolicy(AllocationGuard::Report);
+    const uint64_t before = AllocationGuard::violations();
+    std::thread other;
+    {
+        AllocationGuard::Scope guarded;
+        // Starting a thread allocates its state, so do it unguarded
+        const bool previous = AllocationGuard::arm(false);
+        other = std::thread([] { allocateOnce(); });
+        other.join();
+        AllocationGuard::arm(previous);
+    }
+    EXPECT_EQ(AllocationGuard::violations(), before);
+}
+
+// The control cycle itself runs clean; a stage that outgrows the cycle
+// arena falls back to the heap and is caught on the control thread
+TEST(AllocationGuardTest, CatchesAnAllocationInTheControlCycle) {
+    AllocationGuard::setPolicy(AllocationGuard::Report);
+    HumanoidController controller(200.0);
+    controller.enableVirtualTime();
+    ASSERT_TRUE(controller.beginSimulation());
+    
+    const uint64_t before = AllocationGuard::violations();
+    {
+        AllocationGuard::Scope guarded;
+        for (int cycle = 0; cycle < 50; ++cycle) {
+            controller.stepSimulation();
+        }
+    }
+    EXPECT_EQ(AllocationGuard::violations(), before);
+    EXPECT_GT(controller.cycleArena().peakBytes(), 0u);
+    
+    CycleArena& arena = controller.cycleArena();
+    {
+        AllocationGuard::Scope guarded;
+        controller.stepSimulation();
+        std::pmr::vector<unsigned char> scratch(arena.capacity() + 1, 0, &arena);
+    }
+    EXPECT_EQ(arena.overflows(), 1u);
+    EXPECT_EQ(AllocationGuard::violations(), before + 1);
+}
+
+TEST(AllocationGuardDeathTest, AbortPolicyEndsTheProcess) {
+    GTEST_FLAG_SET(death_test_style, "threadsafe");
+    EXPECT_DEATH({
+        AllocationGuard::setPolicy(AllocationGuard::Abort);
+        AllocationGuard::Scope guarded;
+        allocateOnce();
+    }, "allocation on a guarded real-time thread");
+}
@@ -0,0 +1,67 @@
+// CycleArena: bump allocation, per-cycle reset and the upstream fallback
+
+#include "humanoid_control/allocation.hpp"
+
+#include <gtest/gtest.h>
+
+namespace {
+
+// Counts what reaches the heap behind the arena
+class CountingResource : public std::pmr::memory_resource {
+public:
+    size_t allocations = 0;
+    size_t deallocations = 0;
+
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        ++allocations;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+    
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+        ++deallocations;
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+    
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+
+}  // namespace
+
+TEST(CycleArenaTest, ResetReusesTheBufferAndTracksThePeak) {
+    CountingResource upstream;
+    CycleArena arena(1024, &upstream);
+    
+    const void* first = nullptr;
+    for (int cycle = 0; cycle < 3; ++cycle) {
+        arena.reset();
+        std::pmr::vector<double> scratch(64, 0.0, &arena);
+        if (cycle == 0) first = scratch.data();
+        EXPECT_EQ(scratch.data(), first);
+        EXPECT_EQ(arena.used(), 64 * sizeof(double));
+    }
+    {
+        arena.reset();
+        std::pmr::vector<uint8_t> small(10, 0, &arena);
+        std::pmr::vector<double> aligned(4, 0.0, &arena);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(aligned.data()) % alignof(double), 0u);
+    }
+    EXPECT_EQ(arena.peakBytes(), 64 * sizeof(double));
+    EXPECT_EQ(arena.overflows(), 0u);
+    EXPECT_EQ(upstream.allocations, 0u);
+}
+
+TEST(CycleArenaTest, OverflowFallsBackUpstreamAndIsFreed) {
+    CountingResource upstream;
+    CycleArena arena(256, &upstream);
+    {
+        std::pmr::vector<double> fits(16, 0.0, &arena);
+        std::pmr::vector<double> too_big(64, 0.0, &arena);
+        EXPECT_EQ(arena.overflows(), 1u);
+        EXPECT_EQ(upstream.allocations, 1u);
+    }
+    EXPECT_EQ(upstream.deallocations, 1u);
+    EXPECT_LE(arena.peakBytes(), arena.capacity());
+}
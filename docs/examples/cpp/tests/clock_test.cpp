@@ -0,0 +1,68 @@
+// Cycle clock sources: TSC calibration, sleeping and virtual time
+
+#include "humanoid_control/core.hpp"
+
+#include <gtest/gtest.h>
+
+TEST(CycleClockTest, TscTracksSteadyClock) {
+    CycleClock clock;
+    if (!clock.useTsc(5000000)) {
+        GTEST_SKIP() << "no usable TSC on this machine";
+    }
+    ASSERT_EQ(clock.source(), CycleClock::Source::Tsc);
+    
+    // After calibration, a TSC sample lands within a small window of
+    // steady_clock read right around it
+    for (int i = 0; i < 5; ++i) {
+        const int64_t before = CycleClock::steadyNowNs();
+        const int64_t sample = clock.sample();
+        const int64_t after = CycleClock::steadyNowNs();
+        EXPECT_GT(sample, before - 1000000);
+        EXPECT_LT(sample, after + 1000000);
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+}
+
+TEST(CycleClockTest, TscIsMonotonic) {
+    CycleClock clock;
+    if (!clock.useTsc(5000000)) {
+        GTEST_SKIP() << "no usable TSC on this machine";
+    }
+    int64_t previous = clock.sample();
+    for (int i = 0; i < 100000; ++i) {
+        const int64_t now = clock.sample();
+        ASSERT_GE(now, previous);
+        previous = now;
+    }
+}
+
+// The final spin of a TSC clock waits on the TSC timeline, not steady_clock
+TEST(CycleClockTest, TscSleepReachesTheDeadlineOnItsOwnTimeline) {
+    CycleClock clock;
+    if (!clock.useTsc(5000000)) {
+        GTEST_SKIP() << "no usable TSC on this machine";
+    }
+    for (int i = 0; i < 20; ++i) {
+        const int64_t deadline = clock.sample() + 500000;
+        clock.sleepUntil(deadline, 200000);
+        EXPECT_GE(clock.sample(), deadline);
+    }
+}
+
+TEST(CycleClockTest, VirtualTimeAdvancesOnlyBySleeping) {
+    VirtualTime time(1000);
+    CycleClock clock;
+    clock.useVirtual(&time);
+    ASSERT_TRUE(clock.isVirtual());
+    EXPECT_EQ(clock.sample(), 1000);
+    
+    clock.sleepUntil(5000);
+    EXPECT_EQ(clock.sample(), 5000);
+    
+    // Never moves backwards
+    clock.sleepUntil(2000);
+    EXPECT_EQ(clock.sample(), 5000);
+    
+    clock.publish(clock.sample());
+    EXPECT_EQ(clock.nowNs(), 5000);
+}
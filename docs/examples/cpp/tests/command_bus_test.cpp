@@ -0,0 +1,73 @@
+// CommandBus on virtual time: delayed frames reach the actuators
+
+#include "humanoid_control/actuation.hpp"
+
+#include <gtest/gtest.h>
+
+namespace {
+
+constexpr int64_t kLatencyNs = 3000000;  // Three 1 ms cycles in flight
+
+// A one-actuator bus on virtual time with a 3 ms transaction latency
+struct VirtualBus {
+    VirtualTime time;
+    Actuator actuator{"joint"};
+    EmergencyStop estop;
+    CommandBus bus{kLatencyNs * 1e-9};
+
+    VirtualBus() {
+        bus.attach(&actuator);
+        bus.useVirtualTime(&time);
+        bus.setEmergencyStop(&estop);
+        bus.start();
+    }
+
+    void publish(double torque) {
+        bus.stage(0, torque);
+        bus.publish();
+        time.advanceTo(time.nowNs() + 1000000);
+    }
+};
+
+}  // namespace
+
+TEST(CommandBusTest, FramesWaitForTheirLatency) {
+    VirtualBus rig;
+    rig.publish(1.0);
+    rig.publish(2.0);
+    rig.publish(3.0);
+    EXPECT_EQ(rig.actuator.getTorque(), 0.0);
+    rig.publish(4.0);
+    EXPECT_EQ(rig.actuator.getTorque(), 1.0);
+    EXPECT_EQ(rig.bus.framesSent(), 1u);
+}
+
+TEST(CommandBusTest, StopWritesTheFramesStillInFlight) {
+    VirtualBus rig;
+    for (int i = 1; i <= 10; ++i) {
+        rig.publish(i);
+    }
+    rig.bus.stop();
+    EXPECT_EQ(rig.actuator.getTorque(), 10.0);
+    EXPECT_EQ(rig.bus.framesSent(), 10u);
+    EXPECT_EQ(rig.bus.framesDropped(), 0u);
+}
+
+TEST(CommandBusTest, HaltWritesDueFramesBeforeTheEmergencyStop) {
+    VirtualBus rig;
+    rig.publish(1.0);
+    rig.publish(2.0);
+    rig.time.advanceTo(rig.time.nowNs() + kLatencyNs);
+    rig.bus.halt();
+    EXPECT_EQ(rig.actuator.getTorque(), 2.0);
+    EXPECT_EQ(rig.bus.framesSent(), 2u);
+    
+    // Once the e-stop is active the frames still queued are dropped
+    rig.publish(3.0);
+    rig.estop.trigger(EmergencyStop::Requested, rig.time.nowNs());
+    rig.bus.halt();
+    rig.bus.stop();
+    EXPECT_EQ(rig.actuator.getTorque(), 0.0);
+    EXPECT_EQ(rig.bus.framesSent(), 2u);
+    EXPECT_EQ(rig.bus.framesDropped(), 1u);
+}
@@ -0,0 +1,53 @@
+// PeriodicExecutor: stop() reaches run() however early it is called
+
+#include "humanoid_control/executor.hpp"
+
+#include <gtest/gtest.h>
+
+#include <future>
+
+namespace {
+
+constexpr auto kHangTimeout = std::chrono::seconds(5);
+
+}  // namespace
+
+TEST(ExecutorTest, StopBeforeRunIsNotLost) {
+    PeriodicExecutor executor(1000000);
+    executor.stop();
+    
+    // run() on another thread, the way the watchdog and acquisition use it
+    auto done = std::async(std::launch::async, [&] {
+        executor.run([](const PeriodicExecutor::TickInfo&) { return true; });
+    });
+    ASSERT_EQ(done.wait_for(kHangTimeout), std::future_status::ready);
+    EXPECT_EQ(executor.cycles(), 0u);
+    EXPECT_FALSE(executor.isRunning());
+}
+
+TEST(ExecutorTest, StartThenStopImmediatelyReturns) {
+    PeriodicExecutor executor(1000000);
+    for (int attempt = 0; attempt < 100; ++attempt) {
+        executor.rearm();
+        std::thread thread([&] {
+            executor.run([](const PeriodicExecutor::TickInfo&) { return true; });
+        });
+        executor.stop();
+        auto joined = std::async(std::launch::async, [&] { thread.join(); });
+        ASSERT_EQ(joined.wait_for(kHangTimeout), std::future_status::ready)
+            << "stop() lost on attempt " << attempt;
+    }
+}
+
+TEST(ExecutorTest, RearmAllowsAnotherRun) {
+    VirtualTime time;
+    PeriodicExecutor executor(100000);
+    executor.clock().useVirtual(&time);
+    executor.stop();
+    executor.run([](const PeriodicExecutor::TickInfo&) { return true; });
+    EXPECT_EQ(executor.cycles(), 0u);
+    
+    executor.rearm();
+    executor.run([](const PeriodicExecutor::TickInfo& tick) { return tick.cycle < 9; });
+    EXPECT_EQ(executor.cycles(), 9u);
+}
@@ -0,0 +1,103 @@
+// Balance EKF timing, convergence and covariance health
+
+#include "humanoid_control/fusion.hpp"
+
+#include <gtest/gtest.h>
+
+// Virtual time starts at 0; the interval after a sample stamped 0 must
+// still be predicted with the gyro
+TEST(BalanceEkfTest, PredictsFromASampleAtTimeZero) {
+    const double gyro[3] = {0.5, 0.0, 0.0};
+    const double level[3] = {0.0, 0.0, 9.81};
+    
+    BalanceEkf from_zero;
+    from_zero.updateImu(gyro, level, 0);
+    const double variance_before = from_zero.rollVariance();
+    from_zero.updateImu(gyro, level, 100000000);
+    
+    BalanceEkf from_one;
+    from_one.updateImu(gyro, level, 1);
+    from_one.updateImu(gyro, level, 100000001);
+    
+    EXPECT_EQ(from_zero.roll(), from_one.roll());
+    EXPECT_GT(from_zero.roll(), 0.0);
+    EXPECT_NE(from_zero.rollVariance(), variance_before);
+}
+
+namespace {
+
+constexpr int64_t kImuPeriodNs = 2000000;   // 500 Hz
+
+// Specific force an IMU at rest reads at this attitude
+void gravityAt(double roll, double pitch, double out[3]) {
+    out[0] = -9.81 * std::sin(pitch);
+    out[1] = 9.81 * std::sin(roll) * std::cos(pitch);
+    out[2] = 9.81 * std::cos(roll) * std::cos(pitch);
+}
+
+// Cholesky succeeds only for a symmetric positive definite matrix
+template <size_t N>
+bool isPositiveDefinite(const FixedMatrix<N, N>& a) {
+    FixedMatrix<N, N> inverse;
+    return invertSpd(a, inverse);
+}
+
+}  // namespace
+
+TEST(BalanceEkfTest, ConvergesToAConstantTilt) {
+    const double roll = 0.2, pitch = -0.1;
+    const double gyro[3] = {0.0, 0.0, 0.0};
+    double accel[3];
+    gravityAt(roll, pitch, accel);
+    
+    BalanceEkf ekf;
+    for (int i = 0; i < 2500; ++i) {     // 5 s
+        ekf.updateImu(gyro, accel, i * kImuPeriodNs);
+    }
+    EXPECT_NEAR(ekf.roll(), roll, 1e-3);
+    EXPECT_NEAR(ekf.pitch(), pitch, 1e-3);
+    EXPECT_LT(ekf.rollVariance(), 1e-3);
+}
+
+TEST(BalanceEkfTest, EstimatesGyroBias) {
+    // Standing still and level, with a gyro that reads a constant offset:
+    // the accelerometer pins the attitude, so the drift must go to the bias
+    const double bias_x = 0.02, bias_y = -0.01;
+    const double gyro[3] = {bias_x, bias_y, 0.0};
+    double accel[3];
+    gravityAt(0.0, 0.0, accel);
+    
+    BalanceEkf ekf;
+    for (int i = 0; i < 15000; ++i) {    // 30 s
+        ekf.updateImu(gyro, accel, i * kImuPeriodNs);
+    }
+    const auto& x = ekf.filter().state();
+    EXPECT_NEAR(x(BalanceEkf::BiasX, 0), bias_x, 0.1 * bias_x);
+    EXPECT_NEAR(x(BalanceEkf::BiasY, 0), bias_y, 0.1 * std::fabs(bias_y));
+    EXPECT_NEAR(ekf.roll(), 0.0, 1e-3);
+    EXPECT_NEAR(ekf.pitch(), 0.0, 1e-3);
+}
+
+TEST(BalanceEkfTest, CovarianceStaysSymmetricPositiveDefinite) {
+    // Many Joseph-form updates from both measurement models, with a moving
+    // attitude, must not let rounding break P's symmetry or definiteness
+    BalanceEkf ekf;
+    double accel[3];
+    for (int i = 0; i < 100000; ++i) {
+        const double t = i * kImuPeriodNs * 1e-9;
+        const double roll = 0.1 * std::sin(2.0 * t);
+        const double gyro[3] = {0.2 * std::cos(2.0 * t) + 0.005, -0.003, 0.0};
+        gravityAt(roll, 0.05, accel);
+        ekf.updateImu(gyro, accel, i * kImuPeriodNs);
+        ekf.updateHip(roll + 0.02, i * kImuPeriodNs + kImuPeriodNs / 2);
+    }
+    
+    const auto& p = ekf.filter().covariance();
+    for (size_t r = 0; r < BalanceEkf::kStateSize; ++r) {
+        for (size_t c = 0; c < r; ++c) {
+            const double scale = std::sqrt(p(r, r) * p(c, c));
+            EXPECT_LE(std::fabs(p(r, c) - p(c, r)), 1e-9 * scale) << r << "," << c;
+        }
+    }
+    EXPECT_TRUE(isPositiveDefinite(p));
+}
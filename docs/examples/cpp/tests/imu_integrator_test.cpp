@@ -0,0 +1,123 @@
+// ImuIntegrator: bit-identical AVX2 and scalar paths, small and large steps
+
+#include "humanoid_control/sensors.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstring>
+#include <random>
+
+namespace {
+
+void fill(std::mt19937_64& rng, ImuBatch& batch) {
+    std::uniform_real_distribution<double> unit(-1.0, 1.0);
+    for (size_t i = 0; i < batch.size(); ++i) {
+        const double x = unit(rng), y = unit(rng), z = unit(rng), w = unit(rng);
+        const double norm = std::sqrt(x * x + y * y + z * z + w * w);
+        batch.qx[i] = x / norm;
+        batch.qy[i] = y / norm;
+        batch.qz[i] = z / norm;
+        batch.qw[i] = w / norm;
+        batch.wx[i] = 5.0 * unit(rng);
+        batch.wy[i] = 5.0 * unit(rng);
+        batch.wz[i] = 5.0 * unit(rng);
+        batch.dt[i] = 0.0005 + 0.0005 * std::fabs(unit(rng));
+    }
+}
+
+bool sameBits(double a, double b) {
+    return std::memcmp(&a, &b, sizeof(double)) == 0;
+}
+
+}  // namespace
+
+// Integrated over many steps so any rounding difference would compound
+TEST(ImuIntegratorTest, DispatchedPathMatchesScalarBitForBit) {
+    std::mt19937_64 rng(2024);
+    for (size_t lanes : {1u, 3u, 4u, 5u, 9u, 16u}) {
+        ImuBatch dispatched(lanes);
+        fill(rng, dispatched);
+        ImuBatch scalar(lanes);
+        for (size_t i = 0; i < lanes; ++i) {
+            scalar.qx[i] = dispatched.qx[i];
+            scalar.qy[i] = dispatched.qy[i];
+            scalar.qz[i] = dispatched.qz[i];
+            scalar.qw[i] = dispatched.qw[i];
+            scalar.wx[i] = dispatched.wx[i];
+            scalar.wy[i] = dispatched.wy[i];
+            scalar.wz[i] = dispatched.wz[i];
+            scalar.dt[i] = dispatched.dt[i];
+        }
+        
+        for (int step = 0; step < 1000; ++step) {
+            ImuIntegrator::integrate(dispatched);
+            ImuIntegrator::integrateScalar(scalar, 0, lanes);
+        }
+        for (size_t i = 0; i < lanes; ++i) {
+            EXPECT_TRUE(sameBits(dispatched.qx[i], scalar.qx[i])) << "lanes " << lanes << " lane " << i;
+            EXPECT_TRUE(sameBits(dispatched.qy[i], scalar.qy[i])) << "lanes " << lanes << " lane " << i;
+            EXPECT_TRUE(sameBits(dispatched.qz[i], scalar.qz[i])) << "lanes " << lanes << " lane " << i;
+            EXPECT_TRUE(sameBits(dispatched.qw[i], scalar.qw[i])) << "lanes " << lanes << " lane " << i;
+        }
+    }
+}
+
+TEST(ImuIntegratorTest, StaysNormalized) {
+    std::mt19937_64 rng(7);
+    ImuBatch batch(8);
+    fill(rng, batch);
+    for (int step = 0; step < 10000; ++step) {
+        ImuIntegrator::integrate(batch);
+    }
+    for (size_t i = 0; i < batch.size(); ++i) {
+        const double norm2 = batch.qx[i] * batch.qx[i] + batch.qy[i] * batch.qy[i] +
+                             batch.qz[i] * batch.qz[i] + batch.qw[i] * batch.qw[i];
+        EXPECT_NEAR(norm2, 1.0, 1e-12);
+    }
+}
+
+// A step far beyond the series' range, e.g. the first sample after a
+// sensor gap, must still rotate by exactly |w| dt
+TEST(ImuIntegratorTest, LargeStepsUseTheExactExpMap) {
+    const double angle = 5.0;   // rad in one sample
+    auto setRates = [&](ImuBatch& b) {
+        for (size_t i = 0; i < b.size(); ++i) {
+            b.wz[i] = i == 2 ? 1.0 : 10.0;  // One small lane among large ones
+            b.dt[i] = i == 2 ? 0.001 : angle / 10.0;
+        }
+    };
+    ImuBatch batch(5);
+    setRates(batch);
+    ImuIntegrator::integrate(batch);
+    
+    for (size_t i : {0u, 1u, 3u, 4u}) {
+        EXPECT_NEAR(batch.qx[i], 0.0, 1e-15);
+        EXPECT_NEAR(batch.qy[i], 0.0, 1e-15);
+        EXPECT_NEAR(batch.qz[i], std::sin(angle / 2.0), 1e-15);
+        EXPECT_NEAR(batch.qw[i], std::cos(angle / 2.0), 1e-15);
+    }
+    EXPECT_NEAR(batch.qz[2], std::sin(0.0005), 1e-12);
+    
+    // Same bits as the scalar path, large lanes included
+    ImuBatch scalar(5);
+    setRates(scalar);
+    ImuIntegrator::integrateScalar(scalar, 0, scalar.size());
+    for (size_t i = 0; i < scalar.size(); ++i) {
+        EXPECT_TRUE(sameBits(batch.qz[i], scalar.qz[i])) << "lane " << i;
+        EXPECT_TRUE(sameBits(batch.qw[i], scalar.qw[i])) << "lane " << i;
+    }
+}
+
+TEST(ImuIntegratorTest, SeriesAndExactMapAgreeAtTheSwitch) {
+    // Just below and just above the switch the two maps must line up
+    for (double scale : {0.999999, 1.000001}) {
+        const double h = 0.25 * scale;
+        ImuBatch batch(1);
+        batch.wx[0] = 2.0 * h;
+        batch.dt[0] = 1.0;
+        ImuIntegrator::integrate(batch);
+        EXPECT_NEAR(batch.qx[0], std::sin(h), 1e-9);
+        EXPECT_NEAR(batch.qw[0], std::cos(h), 1e-9);
+    }
+}
@@ -0,0 +1,152 @@
+// AsyncLogger: ring leases, the lock-free overflow path and string lifetime
+
+#include "humanoid_control/logging.hpp"
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+
+namespace {
+
+size_t countLines(const std::string& text, const std::string& needle) {
+    size_t count = 0;
+    for (size_t at = text.find(needle); at != std::string::npos; at = text.find(needle, at + 1)) {
+        ++count;
+    }
+    return count;
+}
+
+}  // namespace
+
+// Threads that come and go hand their rings back, so far more threads than
+// rings can log over a logger's lifetime
+TEST(AsyncLoggerTest, ExitedThreadsReleaseTheirRings) {
+    std::ostringstream out;
+    uint64_t dropped = 0;
+    {
+        AsyncLogger logger(out);
+        for (size_t i = 0; i < 4 * AsyncLogger::kMaxThreads; ++i) {
+            std::thread([&logger, i] {
+                logger.log(LogEvent::EmergencyStopRequested);
+                logger.log(LogEvent::JointSensorDisconnected, static_cast<int>(i));
+            }).join();
+        }
+        logger.flush();
+        dropped = logger.dropped();
+    }
+    EXPECT_EQ(dropped, 0u);
+    EXPECT_EQ(countLines(out.str(), "EMERGENCY STOP ACTIVATED!"), 4 * AsyncLogger::kMaxThreads);
+    EXPECT_EQ(countLines(out.str(), "SAFETY: Joint sensor"), 4 * AsyncLogger::kMaxThreads);
+}
+
+// More live threads than rings: the extra ones go through the overflow ring
+TEST(AsyncLoggerTest, ThreadsBeyondTheRingsAreNotDropped) {
+    constexpr size_t kThreads = 2 * AsyncLogger::kMaxThreads;
+    std::ostringstream out;
+    {
+        AsyncLogger logger(out);
+        std::atomic<size_t> ready{0};
+        std::vector<std::thread> threads;
+        for (size_t i = 0; i < kThreads; ++i) {
+            threads.emplace_back([&] {
+                logger.log(LogEvent::EmergencyStopRequested);
+                // Keep the lease until every thread has logged
+                ready.fetch_add(1);
+                while (ready.load() < kThreads) {
+                    std::this_thread::yield();
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        logger.flush();
+        EXPECT_EQ(logger.dropped(), 0u);
+    }
+    EXPECT_EQ(countLines(out.str(), "EMERGENCY STOP ACTIVATED!"), kThreads);
+}
+
+// Overflow producers race on one shared ring without a lock and lose nothing
+TEST(AsyncLoggerTest, ConcurrentOverflowProducersAreNotDropped) {
+    constexpr size_t kThreads = 2 * AsyncLogger::kMaxThreads;
+    constexpr size_t kRecords = 100;   // Per overflow thread; all fit in one ring
+    std::ostringstream out;
+    {
+        AsyncLogger logger(out);
+        std::atomic<size_t> leased{0};
+        std::vector<std::thread> threads;
+        for (size_t i = 0; i < kThreads; ++i) {
+            threads.emplace_back([&] {
+                // Take a ring if one is left, then log all at once
+                logger.log(LogEvent::EmergencyStopRequested);
+                leased.fetch_add(1);
+                while (leased.load() < kThreads) {
+                    std::this_thread::yield();
+                }
+                for (size_t r = 0; r < kRecords; ++r) {
+                    logger.log(LogEvent::JointSensorDisconnected, static_cast<int>(r));
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        logger.flush();
+        EXPECT_EQ(logger.dropped(), 0u);
+    }
+    EXPECT_EQ(countLines(out.str(), "SAFETY: Joint sensor"), kThreads * kRecords);
+}
+
+// Strings are copied at log time, so the caller's buffer can go away
+TEST(AsyncLoggerTest, StringArgumentsAreCopied) {
+    std::ostringstream out;
+    {
+        AsyncLogger logger(out);
+        std::thread([&logger] {
+            std::string name = "left_hip_with_a_name_too_long_for_small_string_storage";
+            logger.log(LogEvent::ControllerInitialized, name.c_str());
+            name.assign(name.size(), 'x');
+            logger.log(LogEvent::ControllerInitialized, static_cast<const char*>(nullptr));
+        }).join();
+        logger.flush();
+    }
+    EXPECT_NE(out.str().find("Joint controller 'left_hip_with_a_name_too_long_for_small_string_"
+                             "storage' initialized"), std::string::npos);
+    EXPECT_NE(out.str().find("Joint controller '(null)' initialized"), std::string::npos);
+}
+
+// Text that does not fit is truncated, never written past the record
+TEST(AsyncLoggerTest, LongStringsAreTruncated) {
+    std::ostringstream out;
+    {
+        AsyncLogger logger(out);
+        std::thread([&logger] {
+            const std::string text(200, 'a');
+            logger.log(LogEvent::RtAffinityFailed, 3, text.c_str());
+        }).join();
+        logger.flush();
+    }
+    EXPECT_NE(out.str().find("cannot pin to CPU 3: " + std::string(LogRecord::kTextBytes - 1, 'a') +
+                             "\n"), std::string::npos);
+}
+
+// A muted thread drops only its own records, and only while muted
+TEST(AsyncLoggerTest, ThreadMuteIsScopedToItsThread) {
+    std::ostringstream out;
+    {
+        AsyncLogger logger(out);
+        std::thread([&logger] {
+            AsyncLogger::ThreadMute mute;
+            logger.log(LogEvent::JointSensorDisconnected, 1);
+            std::thread([&logger] { logger.log(LogEvent::JointSensorDisconnected, 2); }).join();
+        }).join();
+        std::thread([&logger] {
+            { AsyncLogger::ThreadMute mute; }
+            logger.log(LogEvent::JointSensorDisconnected, 3);
+        }).join();
+        logger.flush();
+    }
+    EXPECT_EQ(out.str().find("Joint sensor 1 "), std::string::npos);
+    EXPECT_NE(out.str().find("Joint sensor 2 "), std::string::npos);
+    EXPECT_NE(out.str().find("Joint sensor 3 "), std::string::npos);
+}
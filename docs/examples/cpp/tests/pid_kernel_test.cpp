@@ -0,0 +1,109 @@
+// PidKernel: the AVX2 path must match the scalar reference bit for bit
+
+#include "humanoid_control/joint_control.hpp"
+
+#include <gtest/gtest.h>
+
+#include <random>
+
+namespace {
+
+// Random gains, targets and states. Roughly a third of the joints are
+// disabled, a third run over their velocity limit or hot enough to derate,
+// and the torque limit is low enough that many commands clamp. Padded
+// tail lanes of the state get garbage; their PID lanes stay disabled.
+void randomize(std::mt19937_64& rng, PidBank& pid, JointStateBank& state) {
+    std::uniform_real_distribution<double> unit(-1.0, 1.0);
+    std::uniform_int_distribution<int> pick(0, 5);
+    for (size_t j = 0; j < pid.size(); ++j) {
+        pid.kp[j] = 50.0 + 100.0 * unit(rng);
+        pid.ki[j] = 10.0 * unit(rng);
+        pid.kd[j] = 5.0 * unit(rng);
+        pid.target[j] = unit(rng);
+        pid.max_velocity[j] = 2.0;
+        pid.max_temperature[j] = 70.0;
+        pid.max_torque[j] = 20.0 + 30.0 * std::fabs(unit(rng));
+        pid.enabled[j] = pick(rng) < 2 ? 0 : -1;
+    }
+    for (size_t j = 0; j < state.paddedSize(); ++j) {
+        const int kind = pick(rng);
+        state.position()[j] = unit(rng);
+        state.velocity()[j] = kind == 3 ? 3.0 * (unit(rng) > 0 ? 1 : -1) : unit(rng);
+        state.temperature()[j] = kind == 4 ? 65.0 + 4.0 * std::fabs(unit(rng)) : 40.0;
+        state.torque()[j] = unit(rng);
+    }
+}
+
+}  // namespace
+
+TEST(PidKernelTest, VerifyModeFindsNoMismatchOnRandomBanks) {
+    std::mt19937_64 rng(12345);
+    std::uniform_real_distribution<double> jitter(-0.01, 0.01);
+    
+    // Sizes below, at and just past a vector width, and a realistic robot
+    for (size_t joints : {1, 3, 4, 5, 7, 8, 13, 40, 61}) {
+        PidBank pid(joints);
+        JointStateBank state(joints);
+        PidKernel kernel(joints, PidKernel::Mode::Verify);
+        AlignedArray<double> torque(joints);
+        randomize(rng, pid, state);
+        
+        for (int step = 0; step < 200; ++step) {
+            // Move the joints a little so integrators and derivatives evolve
+            for (size_t j = 0; j < joints; ++j) {
+                state.position()[j] += jitter(rng);
+            }
+            kernel.step(pid, state, 0.001, torque.data());
+        }
+        EXPECT_EQ(kernel.verifyMismatches(), 0u) << joints << " joints";
+        
+        // Padded lanes stay disabled and untouched by the vector path
+        for (size_t j = joints; j < pid.paddedSize(); ++j) {
+            EXPECT_EQ(torque[j], 0.0) << "padded lane " << j;
+            EXPECT_EQ(pid.error_sum[j], 0.0) << "padded lane " << j;
+            EXPECT_EQ(pid.last_error[j], 0.0) << "padded lane " << j;
+        }
+    }
+}
+
+TEST(PidKernelTest, DisabledJointsOutputZeroAndKeepState) {
+    const size_t joints = 6;
+    std::mt19937_64 rng(7);
+    PidBank pid(joints);
+    JointStateBank state(joints);
+    randomize(rng, pid, state);
+    for (size_t j = 0; j < joints; ++j) {
+        pid.enabled[j] = j % 2 ? -1 : 0;
+        pid.error_sum[j] = 0.25;
+        pid.last_error[j] = 0.5;
+    }
+    
+    PidKernel kernel(joints);
+    AlignedArray<double> torque(joints);
+    kernel.step(pid, state, 0.001, torque.data());
+    for (size_t j = 0; j < joints; j += 2) {
+        EXPECT_EQ(torque[j], 0.0);
+        EXPECT_EQ(pid.error_sum[j], 0.25);
+        EXPECT_EQ(pid.last_error[j], 0.5);
+    }
+}
+
+TEST(PidKernelTest, DeratedCommandIsHalved) {
+    PidBank pid(1);
+    JointStateBank state(1);
+    pid.kp[0] = 10.0;
+    pid.target[0] = 1.0;
+    pid.max_velocity[0] = 5.0;
+    pid.max_temperature[0] = 70.0;
+    pid.max_torque[0] = 100.0;
+    pid.enabled[0] = -1;
+    
+    PidKernel kernel(1);
+    AlignedArray<double> cool(1), hot(1);
+    kernel.step(pid, state, 0.001, cool.data());
+    pid.error_sum[0] = 0.0;
+    pid.last_error[0] = 0.0;
+    state.temperature()[0] = 65.0;
+    kernel.step(pid, state, 0.001, hot.data());
+    EXPECT_EQ(hot[0], cool[0] * 0.5);
+}
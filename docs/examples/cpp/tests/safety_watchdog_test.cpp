@@ -0,0 +1,51 @@
+// SafetyWatchdog: start/stop around its RT setup, and tripping on a stall
+
+#include "humanoid_control/safety_watchdog.hpp"
+
+#include <gtest/gtest.h>
+
+#include <future>
+
+namespace {
+
+constexpr auto kHangTimeout = std::chrono::seconds(5);
+
+// The pieces a watchdog watches, for a two-joint robot
+struct WatchdogRig {
+    JointStateBank state{2};
+    SafetyLimits limits{2};
+    EmergencyStop estop;
+    SafetyMonitor monitor{state, limits, estop};
+    CommandBus bus;
+    SafetyWatchdog watchdog{estop, monitor, bus, SafetyWatchdog::Options()};
+};
+
+}  // namespace
+
+TEST(SafetyWatchdogTest, StopDuringStartUpReturns) {
+    WatchdogRig rig;
+    // stop() usually lands while the thread is still in its RT setup
+    for (int attempt = 0; attempt < 50; ++attempt) {
+        rig.watchdog.start();
+        auto stopped = std::async(std::launch::async, [&] { rig.watchdog.stop(); });
+        ASSERT_EQ(stopped.wait_for(kHangTimeout), std::future_status::ready)
+            << "stop() hung on attempt " << attempt;
+    }
+    EXPECT_FALSE(rig.estop.isActive());
+}
+
+TEST(SafetyWatchdogTest, RestartedWatchdogTripsOnAMissingHeartbeat) {
+    WatchdogRig rig;
+    rig.watchdog.start();
+    rig.watchdog.stop();
+    
+    // No beats at all: the heartbeat timeout must trip the e-stop
+    rig.watchdog.start();
+    const auto deadline = std::chrono::steady_clock::now() + kHangTimeout;
+    while (!rig.estop.isActive() && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    rig.watchdog.stop();
+    EXPECT_TRUE(rig.estop.isActive());
+    EXPECT_GT(rig.watchdog.ticks(), 0u);
+}
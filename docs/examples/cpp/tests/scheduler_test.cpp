@@ -0,0 +1,93 @@
+// RateMonotonicScheduler: base tick validation, pipeline order and stage timing
+
+#include "humanoid_control/scheduler.hpp"
+
+#include <gtest/gtest.h>
+
+namespace {
+
+using Tick = PeriodicExecutor::TickInfo;
+
+constexpr int64_t kMs = 1000000;
+
+// Drive the scheduler the way the executor would, one base tick at a time
+void runTicks(RateMonotonicScheduler& scheduler, int ticks) {
+    const int64_t base = scheduler.basePeriodNs();
+    for (int i = 0; i < ticks; ++i) {
+        const int64_t release = (i + 1) * base;
+        scheduler.tick(Tick{static_cast<uint64_t>(i), release, release, base, 0});
+    }
+}
+
+}  // namespace
+
+TEST(SchedulerTest, RejectsRatesThatCollapseTheBaseTick) {
+    RateMonotonicScheduler scheduler;
+    scheduler.addTask({"a", static_cast<int64_t>(1e9 / 300.0)}, [](const Tick&) {});
+    EXPECT_THROW(scheduler.addTask({"b", static_cast<int64_t>(1e9 / 333.0)}, [](const Tick&) {}),
+                 std::invalid_argument);
+    
+    // The rejected task leaves the schedule as it was
+    EXPECT_EQ(scheduler.taskCount(), 1u);
+    EXPECT_EQ(scheduler.basePeriodNs(), static_cast<int64_t>(1e9 / 300.0));
+}
+
+TEST(SchedulerTest, RejectsNonHarmonicRatesBelowTheMinimumTick) {
+    RateMonotonicScheduler scheduler;
+    scheduler.addTask({"control", 1 * kMs}, [](const Tick&) {});
+    // 1.5 kHz rounds to 666667ns, which shares no divisor with 1ms
+    EXPECT_THROW(scheduler.addTask({"fast", 666667}, [](const Tick&) {}), std::invalid_argument);
+    // A phase can collapse the tick just as well
+    EXPECT_THROW(scheduler.addTask({"late", 2 * kMs, 1001}, [](const Tick&) {}),
+                 std::invalid_argument);
+    EXPECT_EQ(scheduler.basePeriodNs(), 1 * kMs);
+}
+
+TEST(SchedulerTest, AcceptsNonHarmonicRatesWithAUsableTick) {
+    RateMonotonicScheduler scheduler;
+    scheduler.addTask({"a", 2 * kMs, 0, kMs / 2}, [](const Tick&) {});
+    scheduler.addTask({"b", 3 * kMs, 0, kMs / 2}, [](const Tick&) {});
+    EXPECT_EQ(scheduler.basePeriodNs(), 1 * kMs);
+    EXPECT_FALSE(scheduler.isHarmonic());
+    EXPECT_NEAR(scheduler.utilizationBound(), 2.0 * (std::sqrt(2.0) - 1.0), 1e-12);
+    EXPECT_TRUE(scheduler.isSchedulable());
+    
+    scheduler.addTask({"c", 6 * kMs, 0, 3 * kMs}, [](const Tick&) {});
+    EXPECT_FALSE(scheduler.isSchedulable());
+}
+
+TEST(SchedulerTest, RunsSensorStagesBeforeSafetyWithinATick) {
+    RateMonotonicScheduler scheduler;
+    std::vector<std::string> order;
+    // Registered first and faster, but safety must see this tick's samples
+    scheduler.addTask({"safety", kMs / 2, 0, 0, CycleInstrumentation::Safety},
+                      [&](const Tick&) { order.push_back("safety"); });
+    scheduler.addTask({"telemetry", 1 * kMs, 0, 0, CycleInstrumentation::Telemetry},
+                      [&](const Tick&) { order.push_back("telemetry"); });
+    scheduler.addTask({"sensors", 1 * kMs, 0, 0, CycleInstrumentation::SensorRead},
+                      [&](const Tick&) { order.push_back("sensors"); });
+    
+    runTicks(scheduler, 2);
+    const std::vector<std::string> expected{"sensors", "safety", "telemetry", "safety"};
+    EXPECT_EQ(order, expected);
+}
+
+TEST(SchedulerTest, RecordsStageTimePerTick) {
+    RateMonotonicScheduler scheduler;
+    CycleInstrumentation instrumentation;
+    scheduler.setInstrumentation(&instrumentation);
+    scheduler.addTask({"imu", kMs / 2, 0, 0, CycleInstrumentation::SensorRead},
+                      [](const Tick&) {});
+    scheduler.addTask({"joints", 1 * kMs, 0, 0, CycleInstrumentation::SensorRead},
+                      [](const Tick&) {});
+    scheduler.addTask({"control", 1 * kMs, 0, 0, CycleInstrumentation::Control},
+                      [](const Tick&) {});
+    scheduler.addTask({"other", 1 * kMs}, [](const Tick&) {});
+    
+    runTicks(scheduler, 4);
+    // Both sensor tasks sum into one sample per tick
+    EXPECT_EQ(instrumentation.histogram(CycleInstrumentation::SensorRead).count(), 4u);
+    EXPECT_EQ(instrumentation.histogram(CycleInstrumentation::Control).count(), 2u);
+    EXPECT_EQ(instrumentation.histogram(CycleInstrumentation::Fusion).count(), 0u);
+    EXPECT_EQ(instrumentation.histogram(CycleInstrumentation::Total).count(), 0u);
+}
@@ -0,0 +1,72 @@
+// StaticHumanoidController: the shared multi-rate loop on a fixed topology
+
+#include "humanoid_control/humanoid_controller.hpp"
+#include "humanoid_control/static_controller.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+
+namespace {
+
+// Index of a task by name; taskCount() when there is none
+size_t findTask(const RateMonotonicScheduler& scheduler, const char* name) {
+    for (size_t i = 0; i < scheduler.taskCount(); ++i) {
+        if (std::strcmp(scheduler.task(i).name, name) == 0) return i;
+    }
+    return scheduler.taskCount();
+}
+
+}  // namespace
+
+TEST(StaticControllerTest, RunsEachStageAtItsOwnRate) {
+    AsyncLogger::ThreadMute mute;
+    StaticHumanoidController<SixJointBiped> controller(200.0);
+    controller.enableVirtualTime();
+    controller.setDuration(0.5);
+    testing::internal::CaptureStdout();
+    controller.run();
+    const std::string summary = testing::internal::GetCapturedStdout();
+    
+    const RateMonotonicScheduler& scheduler = controller.scheduler();
+    EXPECT_EQ(scheduler.basePeriodNs(), 500000);
+    const uint64_t control = scheduler.runs(findTask(scheduler, "control"));
+    const uint64_t imu = scheduler.runs(findTask(scheduler, "imu"));
+    const uint64_t balance = scheduler.runs(findTask(scheduler, "balance"));
+    ASSERT_GE(control, 90u);
+    // 2 kHz IMU and 500 Hz balance against 200 Hz control, give or take
+    // the releases cut off by the end of the run
+    EXPECT_NEAR(static_cast<double>(imu), 10.0 * control, 10.0);
+    EXPECT_NEAR(static_cast<double>(balance), 2.5 * control, 3.0);
+    
+    // Stage time is recorded per tick, as for HumanoidController
+    const CycleInstrumentation& stages = controller.instrumentation();
+    EXPECT_EQ(stages.histogram(CycleInstrumentation::SensorRead).count(), imu);
+    EXPECT_EQ(stages.histogram(CycleInstrumentation::Fusion).count(), balance);
+    EXPECT_EQ(stages.histogram(CycleInstrumentation::Control).count(), control);
+    EXPECT_NE(summary.find("Base tick: 500.00us"), std::string::npos);
+}
+
+TEST(StaticControllerTest, SharesTheScheduleOfTheDynamicController) {
+    StaticHumanoidController<SixJointBiped> fixed(200.0);
+    HumanoidController dynamic(200.0);
+    fixed.enableVirtualTime();
+    dynamic.enableVirtualTime();
+    ASSERT_TRUE(fixed.beginSimulation());
+    ASSERT_TRUE(dynamic.beginSimulation());
+    ASSERT_TRUE(fixed.stepSimulation());
+    ASSERT_TRUE(dynamic.stepSimulation());
+    
+    // The same stages at the same rates; only telemetry is missing
+    const RateMonotonicScheduler& a = fixed.scheduler();
+    const RateMonotonicScheduler& b = dynamic.scheduler();
+    EXPECT_EQ(a.basePeriodNs(), b.basePeriodNs());
+    EXPECT_EQ(a.taskCount() + 1, b.taskCount());
+    for (size_t i = 0; i < a.taskCount(); ++i) {
+        const size_t j = findTask(b, a.task(i).name);
+        ASSERT_LT(j, b.taskCount()) << a.task(i).name;
+        EXPECT_EQ(a.task(i).period_ns, b.task(j).period_ns);
+        EXPECT_EQ(a.task(i).stage, b.task(j).stage);
+        EXPECT_EQ(a.runs(i), b.runs(j)) << a.task(i).name;
+    }
+}
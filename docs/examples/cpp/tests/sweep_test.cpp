@@ -0,0 +1,64 @@
+// Sweeps: results do not depend on the thread count
+
+#include "humanoid_control/sweep.hpp"
+
+#include <gtest/gtest.h>
+
+namespace {
+
+std::vector<SweepParameters> grid() {
+    std::vector<SweepParameters> parameters;
+    for (double kp : {40.0, 120.0, 400.0}) {
+        for (double noise : {0.001, 0.05}) {
+            SweepParameters p;
+            p.kp = kp;
+            p.kd = kp / 20.0;
+            p.noise_sigma = noise;
+            parameters.push_back(p);
+        }
+    }
+    return parameters;
+}
+
+void expectSameStats(const RunningStats& a, const RunningStats& b, const char* name) {
+    EXPECT_EQ(a.count(), b.count()) << name;
+    EXPECT_EQ(a.mean(), b.mean()) << name;
+    EXPECT_EQ(a.variance(), b.variance()) << name;
+    EXPECT_EQ(a.min(), b.min()) << name;
+    EXPECT_EQ(a.max(), b.max()) << name;
+}
+
+}  // namespace
+
+// Budget overruns are wall-clock measurements and are left out
+TEST(SweepTest, ResultsAreIdenticalForAnyThreadCount) {
+    SweepOptions options;
+    options.duration = 0.25;
+    options.threads = 1;
+    const SweepSummary serial = SweepRunner::run(grid(), options);
+    options.threads = 4;
+    const SweepSummary parallel = SweepRunner::run(grid(), options);
+    
+    ASSERT_EQ(serial.runs, grid().size());
+    ASSERT_EQ(parallel.runs, serial.runs);
+    ASSERT_EQ(parallel.run_metrics.size(), serial.run_metrics.size());
+    for (size_t i = 0; i < serial.run_metrics.size(); ++i) {
+        const SweepRunMetrics& a = serial.run_metrics[i];
+        const SweepRunMetrics& b = parallel.run_metrics[i];
+        EXPECT_EQ(a.run, i);
+        EXPECT_EQ(b.run, i);
+        EXPECT_EQ(a.seed, b.seed);
+        EXPECT_GT(a.cycles, 0u);
+        EXPECT_EQ(a.cycles, b.cycles) << "run " << i;
+        EXPECT_EQ(a.rms_tracking_error, b.rms_tracking_error) << "run " << i;
+        EXPECT_EQ(a.max_tracking_error, b.max_tracking_error) << "run " << i;
+        EXPECT_EQ(a.tripped, b.tripped) << "run " << i;
+        EXPECT_EQ(a.trip_time, b.trip_time) << "run " << i;
+        EXPECT_EQ(a.score, b.score) << "run " << i;
+    }
+    EXPECT_EQ(serial.trips, parallel.trips);
+    expectSameStats(serial.rms_tracking_error, parallel.rms_tracking_error, "rms");
+    expectSameStats(serial.max_tracking_error, parallel.max_tracking_error, "max");
+    expectSameStats(serial.score, parallel.score, "score");
+    EXPECT_EQ(serial.best.run, parallel.best.run);
+}
@@ -0,0 +1,56 @@
+// Telemetry: records read back exactly as written
+
+#include "humanoid_control/telemetry.hpp"
+
+#include "temp_dir.hpp"
+
+#include <gtest/gtest.h>
+
+// Each joint keeps its own sample time, so a stale joint replays as stale
+TEST(TelemetryTest, JointTimestampsRoundTrip) {
+    TempDir dir;
+    TelemetryRecorder::Options options;
+    options.directory = dir.path();
+    options.segment_count = 2;
+    options.segment_bytes = 64 << 10;
+    
+    constexpr size_t kJoints = 5;
+    constexpr int kCycles = 300;    // Wraps into the second segment
+    JointStateBank bank(kJoints);
+    const double commands[kJoints] = {0.1, 0.2, 0.3, 0.4, 0.5};
+    ImuData imus[2];
+    {
+        TelemetryRecorder recorder;
+        ASSERT_TRUE(recorder.open(options, kJoints, 2)) << recorder.lastError();
+        for (int cycle = 0; cycle < kCycles; ++cycle) {
+            const int64_t now = cycle * 5000000LL;
+            for (size_t j = 0; j < kJoints; ++j) {
+                // Joint 2 stopped updating at cycle 10
+                const int64_t sampled = j == 2 ? std::min<int64_t>(now, 50000000) : now - 1000 * j;
+                bank.store(j, JointState{0.01 * cycle + j, 0.0, 0.0, 30.0 + j, sampled});
+            }
+            imus[0].timestamp_ns = now;
+            recorder.record(cycle, now, bank, commands, ArrayView<ImuData>(imus, 2), 0.0, 0, 0);
+        }
+    }
+    
+    TelemetryReader reader;
+    ASSERT_TRUE(reader.open(options)) << reader.lastError();
+    ASSERT_EQ(reader.jointCount(), kJoints);
+    TelemetryFrame frame;
+    int read = 0;
+    while (reader.next(frame)) {
+        const int64_t now = static_cast<int64_t>(frame.cycle) * 5000000LL;
+        EXPECT_EQ(frame.time_ns, now);
+        for (size_t j = 0; j < kJoints; ++j) {
+            const int64_t sampled = j == 2 ? std::min<int64_t>(now, 50000000) : now - 1000 * j;
+            EXPECT_EQ(frame.joints[j].timestamp_ns, sampled) << "cycle " << frame.cycle;
+            EXPECT_EQ(frame.joints[j].temperature, 30.0 + j);
+            EXPECT_EQ(frame.commands[j], commands[j]);
+        }
+        EXPECT_EQ(frame.imus[0].timestamp_ns, now);
+        ++read;
+    }
+    EXPECT_GT(read, 0);
+    EXPECT_EQ(static_cast<uint64_t>(read), reader.recordCount());
+}
@@ -0,0 +1,34 @@
+// Scratch directory for tests that write files, removed with its contents
+
+#ifndef HUMANOID_CONTROL_TESTS_TEMP_DIR_HPP
+#define HUMANOID_CONTROL_TESTS_TEMP_DIR_HPP
+
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+
+class TempDir {
+private:
+    std::string path_;
+
+public:
+    TempDir() {
+        std::string pattern = (std::filesystem::temp_directory_path() / "humanoid_test_XXXXXX").string();
+        if (!mkdtemp(pattern.data())) {
+            throw std::runtime_error("TempDir: mkdtemp failed");
+        }
+        path_ = pattern;
+    }
+    
+    ~TempDir() {
+        std::error_code ignored;
+        std::filesystem::remove_all(path_, ignored);
+    }
+    
+    TempDir(const TempDir&) = delete;
+    TempDir& operator=(const TempDir&) = delete;
+    
+    const std::string& path() const { return path_; }
+};
+
+#endif  // HUMANOID_CONTROL_TESTS_TEMP_DIR_HPP